@@ -0,0 +1,189 @@
+/**
+* simon.hpp - Header-only Simon engine
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_SIMON_HPP
+#define SIMONSPECK_SIMON_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "simonspeck_detail.hpp"
+
+namespace simonspeck {
+
+// Simon round constant sequences z0..z4, bit i = (z >> i) & 1
+inline constexpr std::uint64_t simon_z[5] = {
+    0b0001100111000011010100100010111110110011100001101010010001011111,
+    0b0001011010000110010011111011100010101101000011001001111101110001,
+    0b0011001101101001111110001000010100011001001011000000111011110101,
+    0b0011110000101100111001010001001000000111101001100011010111011011,
+    0b0011110111001001010011000011101000000100011011010110011110001011,
+};
+
+// Simon with M key words, T rounds and z sequence Z on Bits-wide words
+// stored in Word. Round constants are computed at compile time and the
+// Feistel rounds run two at a time so x and y never need swapping.
+template <typename Word, unsigned M, unsigned T, unsigned Z, unsigned Bits = 8 * sizeof(Word)>
+class Simon {
+    using ops = detail::word_ops<Word, Bits>;
+
+public:
+    static_assert(M >= 2 && M <= 4, "Simon takes 2, 3 or 4 key words");
+    static_assert(Z < 5, "Simon has five z sequences");
+
+    using word_type = Word;
+    static constexpr unsigned word_size = Bits;
+    static constexpr unsigned key_words = M;
+    static constexpr unsigned rounds = T;
+    static constexpr unsigned bytes = Bits / 8;
+    static constexpr unsigned block_bytes = 2 * bytes;
+    static constexpr unsigned key_bytes = M * bytes;
+
+    // c ^ z[i] with c = 2^n - 4, the constant xored into key word i + M
+    static constexpr std::array<Word, T - M> make_round_constants()
+    {
+        std::array<Word, T - M> c{};
+        for (unsigned i = 0; i < T - M; i++)
+        {
+            c[i] = static_cast<Word>((ops::mask ^ 3) ^ ((simon_z[Z] >> (i % 62)) & 1));
+        }
+        return c;
+    }
+
+    static constexpr std::array<Word, T - M> round_constants = make_round_constants();
+
+    Simon() = default;
+
+    explicit Simon(const std::uint8_t *key)
+    {
+        set_key(key);
+    }
+
+    void set_key(const std::uint8_t *key)
+    {
+        detail::unroll<M>([&](auto i) {
+            k_[i] = ops::load(key + bytes * i);
+        });
+
+        detail::unroll<T - M>([&](auto j) {
+            constexpr unsigned i = j + M;
+            Word x = ops::template rotate_right<3>(k_[i - 1]);
+            if constexpr (M == 4)
+            {
+                x ^= k_[i - 3];
+            }
+            x ^= ops::template rotate_right<1>(x);
+            k_[i] = static_cast<Word>(x ^ k_[i - M] ^ round_constants[j]);
+        });
+    }
+
+    // f(x) = (S^1 x & S^8 x) ^ S^2 x, masked once
+    static SIMONSPECK_FORCEINLINE Word f(Word x)
+    {
+        return ops::wrap(static_cast<Word>(
+            (ops::template rotate_left_unmasked<1>(x) & ops::template rotate_left_unmasked<8>(x)) ^
+            ops::template rotate_left_unmasked<2>(x)));
+    }
+
+    SIMONSPECK_FORCEINLINE void encrypt(Word &x, Word &y) const
+    {
+        Word a = x, b = y;
+        detail::unroll<T / 2>([&](auto i) {
+            b ^= f(a) ^ k_[2 * i];
+            a ^= f(b) ^ k_[2 * i + 1];
+        });
+        if constexpr (T % 2)
+        {
+            b ^= f(a) ^ k_[T - 1];
+            x = b;
+            y = a;
+        }
+        else
+        {
+            x = a;
+            y = b;
+        }
+    }
+
+    SIMONSPECK_FORCEINLINE void decrypt(Word &x, Word &y) const
+    {
+        Word a = x, b = y;
+        if constexpr (T % 2)
+        {
+            a = y;
+            b = x ^ f(y) ^ k_[T - 1];
+        }
+        detail::unroll<T / 2>([&](auto i) {
+            constexpr unsigned r = 2 * (T / 2 - 1 - i);
+            a ^= f(b) ^ k_[r + 1];
+            b ^= f(a) ^ k_[r];
+        });
+        x = a;
+        y = b;
+    }
+
+    // Blocks are y || x, little endian words, like encrypt_simon_*
+    void encrypt(const std::uint8_t *in, std::uint8_t *out) const
+    {
+        Word y = ops::load(in);
+        Word x = ops::load(in + bytes);
+        encrypt(x, y);
+        ops::store(out, y);
+        ops::store(out + bytes, x);
+    }
+
+    void decrypt(const std::uint8_t *in, std::uint8_t *out) const
+    {
+        Word y = ops::load(in);
+        Word x = ops::load(in + bytes);
+        decrypt(x, y);
+        ops::store(out, y);
+        ops::store(out + bytes, x);
+    }
+
+    const std::array<Word, T> &schedule() const
+    {
+        return k_;
+    }
+
+private:
+    std::array<Word, T> k_{};
+};
+
+using Simon64_32 = Simon<std::uint16_t, 4, 32, 0>;
+using Simon72_48 = Simon<std::uint32_t, 3, 36, 0, 24>;
+using Simon96_48 = Simon<std::uint32_t, 4, 36, 1, 24>;
+using Simon96_64 = Simon<std::uint32_t, 3, 42, 2>;
+using Simon128_64 = Simon<std::uint32_t, 4, 44, 3>;
+using Simon96_96 = Simon<std::uint64_t, 2, 52, 2, 48>;
+using Simon144_96 = Simon<std::uint64_t, 3, 54, 3, 48>;
+using Simon128_128 = Simon<std::uint64_t, 2, 68, 2>;
+using Simon192_128 = Simon<std::uint64_t, 3, 69, 3>;
+using Simon256_128 = Simon<std::uint64_t, 4, 72, 4>;
+
+} // namespace simonspeck
+
+#endif
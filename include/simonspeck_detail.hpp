@@ -0,0 +1,136 @@
+/**
+* simonspeck_detail.hpp - Shared helpers for the header-only C++ engines
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_DETAIL_HPP
+#define SIMONSPECK_DETAIL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__)
+#define SIMONSPECK_FORCEINLINE inline __attribute__((always_inline))
+#else
+#define SIMONSPECK_FORCEINLINE inline
+#endif
+
+namespace simonspeck {
+namespace detail {
+
+// Word arithmetic for a Bits-wide word stored in Word. The mask is only
+// applied when Bits does not fill Word (24 and 48 bit words).
+template <typename Word, unsigned Bits>
+struct word_ops {
+    static_assert(std::is_unsigned<Word>::value, "Word must be unsigned");
+    static_assert(Bits % 8 == 0 && Bits <= 8 * sizeof(Word), "Bits must fit in Word");
+
+    static constexpr bool native = Bits == 8 * sizeof(Word);
+    static constexpr Word mask = static_cast<Word>(~std::uint64_t(0) >> (64 - Bits));
+    static constexpr unsigned bytes = Bits / 8;
+
+    static constexpr Word wrap(Word x)
+    {
+        return native ? x : static_cast<Word>(x & mask);
+    }
+
+    // Rotates of a wrapped word, leaving garbage above Bits for the caller
+    // to mask along with a later add or xor
+    template <unsigned R>
+    static constexpr Word rotate_left_unmasked(Word x)
+    {
+        return static_cast<Word>((x << R) | (x >> (Bits - R)));
+    }
+
+    template <unsigned R>
+    static constexpr Word rotate_right_unmasked(Word x)
+    {
+        return static_cast<Word>((x >> R) | (x << (Bits - R)));
+    }
+
+    template <unsigned R>
+    static constexpr Word rotate_left(Word x)
+    {
+        return wrap(rotate_left_unmasked<R>(x));
+    }
+
+    template <unsigned R>
+    static constexpr Word rotate_right(Word x)
+    {
+        return wrap(rotate_right_unmasked<R>(x));
+    }
+
+    static constexpr Word add(Word x, Word y)
+    {
+        return wrap(static_cast<Word>(x + y));
+    }
+
+    static constexpr Word sub(Word x, Word y)
+    {
+        return wrap(static_cast<Word>(x - y));
+    }
+
+    static constexpr Word bitnot(Word x)
+    {
+        return wrap(static_cast<Word>(~x));
+    }
+
+    static SIMONSPECK_FORCEINLINE Word load(const std::uint8_t *p)
+    {
+        Word v = 0;
+        for (unsigned i = 0; i < bytes; i++)
+        {
+            v = static_cast<Word>(v | static_cast<Word>(static_cast<Word>(p[i]) << (8 * i)));
+        }
+        return v;
+    }
+
+    static SIMONSPECK_FORCEINLINE void store(std::uint8_t *p, Word v)
+    {
+        for (unsigned i = 0; i < bytes; i++)
+        {
+            p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+        }
+    }
+};
+
+// Calls f(std::integral_constant<std::size_t, I>) for I = 0 .. N - 1, unrolled
+template <typename F, std::size_t... I>
+SIMONSPECK_FORCEINLINE void unroll(F &&f, std::index_sequence<I...>)
+{
+    (f(std::integral_constant<std::size_t, I>{}), ...);
+}
+
+template <std::size_t N, typename F>
+SIMONSPECK_FORCEINLINE void unroll(F &&f)
+{
+    unroll(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+} // namespace detail
+} // namespace simonspeck
+
+#endif
@@ -0,0 +1,155 @@
+/**
+* speck.hpp - Header-only Speck engine
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_SPECK_HPP
+#define SIMONSPECK_SPECK_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "simonspeck_detail.hpp"
+
+namespace simonspeck {
+
+// Speck with M key words and T rounds on Bits-wide words stored in Word.
+// The 16, 32 and 64 bit variants carry no masking at all; only the 24 and
+// 48 bit words are masked, once per rotate and modular add.
+template <typename Word, unsigned M, unsigned T, unsigned Bits = 8 * sizeof(Word)>
+class Speck {
+    using ops = detail::word_ops<Word, Bits>;
+
+public:
+    static_assert(M >= 2 && M <= 4, "Speck takes 2, 3 or 4 key words");
+
+    using word_type = Word;
+    static constexpr unsigned word_size = Bits;
+    static constexpr unsigned key_words = M;
+    static constexpr unsigned rounds = T;
+    static constexpr unsigned bytes = Bits / 8;
+    static constexpr unsigned block_bytes = 2 * bytes;
+    static constexpr unsigned key_bytes = M * bytes;
+    static constexpr unsigned rotation_alpha = Bits == 16 ? 7 : 8;
+    static constexpr unsigned rotation_beta = Bits == 16 ? 2 : 3;
+
+    Speck() = default;
+
+    explicit Speck(const std::uint8_t *key)
+    {
+        set_key(key);
+    }
+
+    void set_key(const std::uint8_t *key)
+    {
+        std::array<Word, M - 1> l;
+        k_[0] = ops::load(key);
+        detail::unroll<M - 1>([&](auto i) {
+            l[i] = ops::load(key + bytes * (i + 1));
+        });
+
+        // l[i + m - 1] takes the slot of l[i], which is not needed afterwards
+        detail::unroll<T - 1>([&](auto i) {
+            Word &li = l[i % (M - 1)];
+            li = static_cast<Word>(ops::add(ops::template rotate_right<rotation_alpha>(li), k_[i]) ^ Word(i));
+            k_[i + 1] = static_cast<Word>(ops::template rotate_left<rotation_beta>(k_[i]) ^ li);
+        });
+    }
+
+    // One mask for the add and one for the rotate of y on odd widths
+    static SIMONSPECK_FORCEINLINE void round(Word &x, Word &y, Word k)
+    {
+        x = static_cast<Word>(ops::add(ops::template rotate_right_unmasked<rotation_alpha>(x), y) ^ k);
+        y = ops::wrap(static_cast<Word>(ops::template rotate_left_unmasked<rotation_beta>(y) ^ x));
+    }
+
+    static SIMONSPECK_FORCEINLINE void inverse_round(Word &x, Word &y, Word k)
+    {
+        y = ops::template rotate_right<rotation_beta>(static_cast<Word>(y ^ x));
+        x = ops::template rotate_left<rotation_alpha>(ops::sub(static_cast<Word>(x ^ k), y));
+    }
+
+    // Works on copies so x and y may alias without forcing reloads
+    SIMONSPECK_FORCEINLINE void encrypt(Word &x, Word &y) const
+    {
+        Word a = x, b = y;
+        detail::unroll<T>([&](auto i) {
+            round(a, b, k_[i]);
+        });
+        x = a;
+        y = b;
+    }
+
+    SIMONSPECK_FORCEINLINE void decrypt(Word &x, Word &y) const
+    {
+        Word a = x, b = y;
+        detail::unroll<T>([&](auto i) {
+            inverse_round(a, b, k_[T - 1 - i]);
+        });
+        x = a;
+        y = b;
+    }
+
+    // Blocks are y || x, little endian words, like encrypt_speck_*
+    void encrypt(const std::uint8_t *in, std::uint8_t *out) const
+    {
+        Word y = ops::load(in);
+        Word x = ops::load(in + bytes);
+        encrypt(x, y);
+        ops::store(out, y);
+        ops::store(out + bytes, x);
+    }
+
+    void decrypt(const std::uint8_t *in, std::uint8_t *out) const
+    {
+        Word y = ops::load(in);
+        Word x = ops::load(in + bytes);
+        decrypt(x, y);
+        ops::store(out, y);
+        ops::store(out + bytes, x);
+    }
+
+    const std::array<Word, T> &schedule() const
+    {
+        return k_;
+    }
+
+private:
+    std::array<Word, T> k_{};
+};
+
+using Speck64_32 = Speck<std::uint16_t, 4, 22>;
+using Speck72_48 = Speck<std::uint32_t, 3, 22, 24>;
+using Speck96_48 = Speck<std::uint32_t, 4, 23, 24>;
+using Speck96_64 = Speck<std::uint32_t, 3, 26>;
+using Speck128_64 = Speck<std::uint32_t, 4, 27>;
+using Speck96_96 = Speck<std::uint64_t, 2, 28, 48>;
+using Speck144_96 = Speck<std::uint64_t, 3, 29, 48>;
+using Speck128_128 = Speck<std::uint64_t, 2, 32>;
+using Speck192_128 = Speck<std::uint64_t, 3, 33>;
+using Speck256_128 = Speck<std::uint64_t, 4, 34>;
+
+} // namespace simonspeck
+
+#endif
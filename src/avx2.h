@@ -0,0 +1,218 @@
+/**
+* avx2.h - AVX2 helpers shared by the kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_AVX2_H
+#define SIMONSPECK_AVX2_H
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+// Rotations by whole bytes are a byte shuffle within each lane
+SS_INLINE __m256i ss_avx2_ror8_64(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 2, 3, 4, 5, 6, 7, 0, 9, 10, 11, 12, 13, 14, 15, 8,
+                                             1, 2, 3, 4, 5, 6, 7, 0, 9, 10, 11, 12, 13, 14, 15, 8);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m256i ss_avx2_rol8_64(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(7, 0, 1, 2, 3, 4, 5, 6, 15, 8, 9, 10, 11, 12, 13, 14,
+                                             7, 0, 1, 2, 3, 4, 5, 6, 15, 8, 9, 10, 11, 12, 13, 14);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m256i ss_avx2_ror8_32(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                             1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m256i ss_avx2_rol8_32(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                             3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+// Rotating a 16-bit lane by 8 either way swaps its bytes
+SS_INLINE __m256i ss_avx2_rot8_16(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                             1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+// 64 bytes of blocks y || x <-> a vector of y words and one of x words.
+// The lanes end up out of block order, the store undoes it.
+
+// 64-bit words, 4 blocks: the unpack gives block order 0 2 1 3
+SS_INLINE void ss_avx2_load_64(const uint8_t *in, __m256i *x, __m256i *y)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i *)in);
+    __m256i b = _mm256_loadu_si256((const __m256i *)(in + 32));
+    *y = _mm256_unpacklo_epi64(a, b);
+    *x = _mm256_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx2_store_64(uint8_t *out, __m256i x, __m256i y)
+{
+    _mm256_storeu_si256((__m256i *)out, _mm256_unpacklo_epi64(y, x));
+    _mm256_storeu_si256((__m256i *)(out + 32), _mm256_unpackhi_epi64(y, x));
+}
+
+// 32-bit words, 8 blocks: swapping the middle words of each 128-bit half
+// pairs up y0 y1 x0 x1, the 64-bit unpack then gathers the words
+SS_INLINE void ss_avx2_load_32(const uint8_t *in, __m256i *x, __m256i *y)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i *)in);
+    __m256i b = _mm256_loadu_si256((const __m256i *)(in + 32));
+    a = _mm256_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm256_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+    *y = _mm256_unpacklo_epi64(a, b);
+    *x = _mm256_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx2_store_32(uint8_t *out, __m256i x, __m256i y)
+{
+    __m256i a = _mm256_shuffle_epi32(_mm256_unpacklo_epi64(y, x), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i b = _mm256_shuffle_epi32(_mm256_unpackhi_epi64(y, x), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256((__m256i *)out, a);
+    _mm256_storeu_si256((__m256i *)(out + 32), b);
+}
+
+// 16-bit words, 16 blocks: a byte shuffle sorts each 128-bit half into
+// y0..y3 x0..x3, the 64-bit unpack then gathers the words
+SS_INLINE void ss_avx2_load_16(const uint8_t *in, __m256i *x, __m256i *y)
+{
+    const __m256i split = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15,
+                                           0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+    __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)in), split);
+    __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(in + 32)), split);
+    *y = _mm256_unpacklo_epi64(a, b);
+    *x = _mm256_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx2_store_16(uint8_t *out, __m256i x, __m256i y)
+{
+    const __m256i merge = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+                                           0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    _mm256_storeu_si256((__m256i *)out, _mm256_shuffle_epi8(_mm256_unpacklo_epi64(y, x), merge));
+    _mm256_storeu_si256((__m256i *)(out + 32), _mm256_shuffle_epi8(_mm256_unpackhi_epi64(y, x), merge));
+}
+
+// 24 and 48-bit words: 48 bytes of 6 or 12-byte blocks, 12 bytes to each
+// 128-bit half by a dword permute. A byte shuffle then spreads them into
+// zero extended words in the order the 64-bit unpack wants, y0 y1 x0 x1
+// for 24-bit words, y x for 48, or packs them back.
+SS_INLINE void ss_avx2_widen(const uint8_t *in, __m256i spread, __m256i *a, __m256i *b)
+{
+    const __m256i lo = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i hi = _mm256_setr_epi32(2, 3, 4, 0, 5, 6, 7, 0);
+    *a = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)in), lo), spread);
+    *b = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(in + 16)), hi), spread);
+}
+
+SS_INLINE void ss_avx2_narrow(uint8_t *out, __m256i a, __m256i b, __m256i pack)
+{
+    const __m256i lo = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 0, 0);
+    const __m256i hi = _mm256_setr_epi32(2, 4, 5, 6, 0, 0, 0, 1);
+    a = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(a, pack), lo);
+    b = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(b, pack), hi);
+    _mm256_storeu_si256((__m256i *)out, _mm256_blend_epi32(a, b, 0xc0));
+    _mm_storeu_si128((__m128i *)(out + 32), _mm256_castsi256_si128(b));
+}
+
+// 24-bit words, 8 blocks of 6 bytes
+SS_INLINE void ss_avx2_load_24(const uint8_t *in, __m256i *x, __m256i *y)
+{
+    const __m256i spread = _mm256_setr_epi8(0, 1, 2, -1, 6, 7, 8, -1, 3, 4, 5, -1, 9, 10, 11, -1,
+                                            0, 1, 2, -1, 6, 7, 8, -1, 3, 4, 5, -1, 9, 10, 11, -1);
+    __m256i a, b;
+    ss_avx2_widen(in, spread, &a, &b);
+    *y = _mm256_unpacklo_epi64(a, b);
+    *x = _mm256_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx2_store_24(uint8_t *out, __m256i x, __m256i y)
+{
+    const __m256i pack = _mm256_setr_epi8(0, 1, 2, 8, 9, 10, 4, 5, 6, 12, 13, 14, -1, -1, -1, -1,
+                                          0, 1, 2, 8, 9, 10, 4, 5, 6, 12, 13, 14, -1, -1, -1, -1);
+    ss_avx2_narrow(out, _mm256_unpacklo_epi64(y, x), _mm256_unpackhi_epi64(y, x), pack);
+}
+
+// 48-bit words, 4 blocks of 12 bytes
+SS_INLINE void ss_avx2_load_48(const uint8_t *in, __m256i *x, __m256i *y)
+{
+    const __m256i spread = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1,
+                                            0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+    __m256i a, b;
+    ss_avx2_widen(in, spread, &a, &b);
+    *y = _mm256_unpacklo_epi64(a, b);
+    *x = _mm256_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx2_store_48(uint8_t *out, __m256i x, __m256i y)
+{
+    const __m256i pack = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1,
+                                          0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 12, 13, -1, -1, -1, -1);
+    ss_avx2_narrow(out, _mm256_unpacklo_epi64(y, x), _mm256_unpackhi_epi64(y, x), pack);
+}
+
+// Byte rotations of a 24 or 48-bit word in a wider lane, which also clear
+// the bits above it
+SS_INLINE __m256i ss_avx2_ror8_24(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 2, 0, -1, 5, 6, 4, -1, 9, 10, 8, -1, 13, 14, 12, -1,
+                                             1, 2, 0, -1, 5, 6, 4, -1, 9, 10, 8, -1, 13, 14, 12, -1);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m256i ss_avx2_rol8_24(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 0, 1, -1, 6, 4, 5, -1, 10, 8, 9, -1, 14, 12, 13, -1,
+                                             2, 0, 1, -1, 6, 4, 5, -1, 10, 8, 9, -1, 14, 12, 13, -1);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m256i ss_avx2_ror8_48(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 2, 3, 4, 5, 0, -1, -1, 9, 10, 11, 12, 13, 8, -1, -1,
+                                             1, 2, 3, 4, 5, 0, -1, -1, 9, 10, 11, 12, 13, 8, -1, -1);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m256i ss_avx2_rol8_48(__m256i v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(5, 0, 1, 2, 3, 4, -1, -1, 13, 8, 9, 10, 11, 12, -1, -1,
+                                             5, 0, 1, 2, 3, 4, -1, -1, 13, 8, 9, 10, 11, 12, -1, -1);
+    return _mm256_shuffle_epi8(v, shuffle);
+}
+
+#endif
@@ -0,0 +1,136 @@
+/**
+* avx512.h - AVX-512 helpers shared by the kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_AVX512_H
+#define SIMONSPECK_AVX512_H
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+// 128 bytes of blocks y || x in two registers, or the first bytes of them
+// (a multiple of 4) with masked loads that zero the rest and do not fault
+// past the end
+SS_INLINE void ss_avx512_load_bytes(const uint8_t *in, size_t bytes, __m512i *a, __m512i *b)
+{
+    uint32_t mask = (uint32_t)((UINT64_C(1) << (bytes / 4)) - 1);
+    *a = _mm512_maskz_loadu_epi32((__mmask16)mask, in);
+    *b = _mm512_maskz_loadu_epi32((__mmask16)(mask >> 16), in + 64);
+}
+
+SS_INLINE void ss_avx512_store_bytes(uint8_t *out, size_t bytes, __m512i a, __m512i b)
+{
+    uint32_t mask = (uint32_t)((UINT64_C(1) << (bytes / 4)) - 1);
+    _mm512_mask_storeu_epi32(out, (__mmask16)mask, a);
+    _mm512_mask_storeu_epi32(out + 64, (__mmask16)(mask >> 16), b);
+}
+
+// Split two registers of blocks into y and x word vectors and merge them
+// back, the same shuffles as the AVX2 kernels within every 128-bit lane
+
+SS_INLINE void ss_avx512_split_64(__m512i a, __m512i b, __m512i *x, __m512i *y)
+{
+    *y = _mm512_unpacklo_epi64(a, b);
+    *x = _mm512_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx512_merge_64(__m512i x, __m512i y, __m512i *a, __m512i *b)
+{
+    *a = _mm512_unpacklo_epi64(y, x);
+    *b = _mm512_unpackhi_epi64(y, x);
+}
+
+SS_INLINE void ss_avx512_split_32(__m512i a, __m512i b, __m512i *x, __m512i *y)
+{
+    a = _mm512_shuffle_epi32(a, (_MM_PERM_ENUM)_MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm512_shuffle_epi32(b, (_MM_PERM_ENUM)_MM_SHUFFLE(3, 1, 2, 0));
+    *y = _mm512_unpacklo_epi64(a, b);
+    *x = _mm512_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx512_merge_32(__m512i x, __m512i y, __m512i *a, __m512i *b)
+{
+    *a = _mm512_shuffle_epi32(_mm512_unpacklo_epi64(y, x), (_MM_PERM_ENUM)_MM_SHUFFLE(3, 1, 2, 0));
+    *b = _mm512_shuffle_epi32(_mm512_unpackhi_epi64(y, x), (_MM_PERM_ENUM)_MM_SHUFFLE(3, 1, 2, 0));
+}
+
+#if defined(__AVX512BW__)
+SS_INLINE void ss_avx512_split_16(__m512i a, __m512i b, __m512i *x, __m512i *y)
+{
+    const __m512i split = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13,
+                                                               2, 3, 6, 7, 10, 11, 14, 15));
+    a = _mm512_shuffle_epi8(a, split);
+    b = _mm512_shuffle_epi8(b, split);
+    *y = _mm512_unpacklo_epi64(a, b);
+    *x = _mm512_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_avx512_merge_16(__m512i x, __m512i y, __m512i *a, __m512i *b)
+{
+    const __m512i merge = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11,
+                                                               4, 5, 12, 13, 6, 7, 14, 15));
+    *a = _mm512_shuffle_epi8(_mm512_unpacklo_epi64(y, x), merge);
+    *b = _mm512_shuffle_epi8(_mm512_unpackhi_epi64(y, x), merge);
+}
+#endif
+
+// Kernel loads and stores of full and partial register pairs, for words
+// of w bits and so blocks of w / 4 bytes
+#define SS_AVX512_LOAD_STORE(w) \
+    SS_INLINE void ss_avx512_load_##w(const uint8_t *in, __m512i *x, __m512i *y) \
+    { \
+        ss_avx512_split_##w(_mm512_loadu_si512(in), _mm512_loadu_si512(in + 64), x, y); \
+    } \
+    SS_INLINE void ss_avx512_store_##w(uint8_t *out, __m512i x, __m512i y) \
+    { \
+        __m512i a, b; \
+        ss_avx512_merge_##w(x, y, &a, &b); \
+        _mm512_storeu_si512(out, a); \
+        _mm512_storeu_si512(out + 64, b); \
+    } \
+    SS_INLINE void ss_avx512_load_partial_##w(const uint8_t *in, size_t n, __m512i *x, __m512i *y) \
+    { \
+        __m512i a, b; \
+        ss_avx512_load_bytes(in, n * (w / 4), &a, &b); \
+        ss_avx512_split_##w(a, b, x, y); \
+    } \
+    SS_INLINE void ss_avx512_store_partial_##w(uint8_t *out, size_t n, __m512i x, __m512i y) \
+    { \
+        __m512i a, b; \
+        ss_avx512_merge_##w(x, y, &a, &b); \
+        ss_avx512_store_bytes(out, n * (w / 4), a, b); \
+    }
+
+SS_AVX512_LOAD_STORE(64)
+SS_AVX512_LOAD_STORE(32)
+#if defined(__AVX512BW__)
+SS_AVX512_LOAD_STORE(16)
+#endif
+
+#undef SS_AVX512_LOAD_STORE
+
+#endif
@@ -0,0 +1,198 @@
+/**
+* cbc.c - Cipher block chaining mode
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+void ss_cbc_encrypt(const simonspeck_ctx *ctx, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    size_t block_bytes = ss_block_bytes(ctx);
+
+    // Each block depends on the last, so this stays one block at a time
+    for (size_t i = 0; i < nblocks; i++)
+    {
+        ss_xor(iv, iv, in, block_bytes);
+        ctx->ops->encrypt(ctx->schedule, iv, iv);
+        memcpy(out, iv, block_bytes);
+        in += block_bytes;
+        out += block_bytes;
+    }
+}
+
+void ss_cbc_decrypt(const simonspeck_ctx *ctx, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t plain[SS_BATCH_BYTES];
+    size_t block_bytes = ss_block_bytes(ctx);
+    size_t batch = SS_BATCH_BYTES / block_bytes;
+    uint8_t next_iv[16];
+
+    while (nblocks > 0)
+    {
+        size_t n = nblocks < batch ? nblocks : batch;
+        ss_decrypt_blocks(ctx, in, plain, n);
+
+        // Backwards, so with in == out no ciphertext is overwritten before
+        // the block after it has used it
+        memcpy(next_iv, in + (n - 1) * block_bytes, block_bytes);
+        for (size_t i = n - 1; i > 0; i--)
+        {
+            ss_xor(out + i * block_bytes, plain + i * block_bytes, in + (i - 1) * block_bytes, block_bytes);
+        }
+        ss_xor(out, plain, iv, block_bytes);
+        memcpy(iv, next_iv, block_bytes);
+
+        in += n * block_bytes;
+        out += n * block_bytes;
+        nblocks -= n;
+    }
+}
+
+int simonspeck_cbc_encrypt(const simonspeck_ctx *ctx, const uint8_t *iv,
+                           const uint8_t *in, uint8_t *out, size_t len)
+{
+    uint8_t chain[16];
+    size_t block_bytes = ss_block_bytes(ctx);
+
+    if (len % block_bytes != 0)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    memcpy(chain, iv, block_bytes);
+    ss_cbc_encrypt(ctx, chain, in, out, len / block_bytes);
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_cbc_decrypt(const simonspeck_ctx *ctx, const uint8_t *iv,
+                           const uint8_t *in, uint8_t *out, size_t len)
+{
+    uint8_t chain[16];
+    size_t block_bytes = ss_block_bytes(ctx);
+
+    if (len % block_bytes != 0)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    memcpy(chain, iv, block_bytes);
+    ss_cbc_decrypt(ctx, chain, in, out, len / block_bytes);
+    return SIMONSPECK_OK;
+}
+
+struct simonspeck_cbc_stream {
+    const simonspeck_ctx *ctx;
+    int decrypt;
+    size_t pending; // bytes in buf
+    uint8_t iv[16];
+    uint8_t buf[16];
+};
+
+simonspeck_cbc_stream *simonspeck_cbc_stream_new(const simonspeck_ctx *ctx)
+{
+    simonspeck_cbc_stream *s = calloc(1, sizeof(*s));
+    if (s != NULL)
+    {
+        s->ctx = ctx;
+    }
+    return s;
+}
+
+void simonspeck_cbc_stream_free(simonspeck_cbc_stream *s)
+{
+    if (s == NULL)
+    {
+        return;
+    }
+
+    volatile uint8_t *p = (volatile uint8_t *)s;
+    for (size_t i = 0; i < sizeof(*s); i++)
+    {
+        p[i] = 0;
+    }
+    free(s);
+}
+
+int simonspeck_cbc_stream_init(simonspeck_cbc_stream *s, const uint8_t *iv, int decrypt)
+{
+    s->decrypt = decrypt;
+    s->pending = 0;
+    memcpy(s->iv, iv, ss_block_bytes(s->ctx));
+    return SIMONSPECK_OK;
+}
+
+static void ss_cbc_stream_blocks(simonspeck_cbc_stream *s, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    if (s->decrypt)
+    {
+        ss_cbc_decrypt(s->ctx, s->iv, in, out, nblocks);
+    }
+    else
+    {
+        ss_cbc_encrypt(s->ctx, s->iv, in, out, nblocks);
+    }
+}
+
+int simonspeck_cbc_stream_update(simonspeck_cbc_stream *s, const uint8_t *in, size_t len,
+                                 uint8_t *out, size_t *out_len)
+{
+    size_t block_bytes = ss_block_bytes(s->ctx);
+
+    *out_len = 0;
+
+    // Complete the buffered block first
+    if (s->pending != 0)
+    {
+        size_t n = block_bytes - s->pending < len ? block_bytes - s->pending : len;
+        memcpy(s->buf + s->pending, in, n);
+        s->pending += n;
+        in += n;
+        len -= n;
+        if (s->pending < block_bytes)
+        {
+            return SIMONSPECK_OK;
+        }
+        ss_cbc_stream_blocks(s, s->buf, out, 1);
+        s->pending = 0;
+        out += block_bytes;
+        *out_len = block_bytes;
+    }
+
+    size_t nblocks = len / block_bytes;
+    ss_cbc_stream_blocks(s, in, out, nblocks);
+    *out_len += nblocks * block_bytes;
+
+    s->pending = len - nblocks * block_bytes;
+    memcpy(s->buf, in + nblocks * block_bytes, s->pending);
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_cbc_stream_final(simonspeck_cbc_stream *s)
+{
+    return s->pending == 0 ? SIMONSPECK_OK : SIMONSPECK_EINVAL;
+}
@@ -0,0 +1,247 @@
+/**
+* ctr.c - Counter mode
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+void ss_ctr_add(uint8_t *ctr, size_t block_bytes, unsigned counter_bytes, uint64_t n)
+{
+    uint8_t *p = ctr + block_bytes;
+    for (unsigned i = 0; i < counter_bytes && n != 0; i++)
+    {
+        uint64_t v = *--p + (n & 0xff);
+        *p = (uint8_t)v;
+        n = (n >> 8) + (v >> 8);
+    }
+}
+
+uint64_t ss_ctr_blocks_left(const uint8_t *ctr, size_t block_bytes, unsigned counter_bytes)
+{
+    // A byte above the low 8 that can still be incremented leaves at least
+    // 2^64 blocks, more than any len covers
+    unsigned low = counter_bytes < 8 ? counter_bytes : 8;
+    for (size_t i = block_bytes - counter_bytes; i < block_bytes - low; i++)
+    {
+        if (ctr[i] != 0xff)
+        {
+            return UINT64_MAX;
+        }
+    }
+
+    uint64_t value = 0;
+    for (size_t i = block_bytes - low; i < block_bytes; i++)
+    {
+        value = (value << 8) | ctr[i];
+    }
+    if (low < 8)
+    {
+        return ((uint64_t)1 << (8 * low)) - value;
+    }
+    // 2^64 - value, and 2^64 itself saturates
+    return value == 0 ? UINT64_MAX : 0 - value;
+}
+
+// Counter blocks whose counter fits in their last 8 bytes: the tail is
+// counted as an integer and the head bytes in front of it are constant
+SS_INLINE void ss_ctr_fill_tail(uint8_t *keystream, const uint8_t *ctr, size_t block_bytes, uint64_t tail,
+                                uint64_t mask, size_t nblocks)
+{
+    uint64_t head = ss_load_le(ctr, 8);
+    for (size_t i = 0; i < nblocks; i++)
+    {
+        uint64_t v = (tail & ~mask) | ((tail + i) & mask);
+        ss_store_le(keystream + i * block_bytes, head, block_bytes - 8);
+        ss_store_le(keystream + i * block_bytes + block_bytes - 8, __builtin_bswap64(v), 8);
+    }
+}
+
+// nblocks consecutive counter blocks from ctr, which is advanced past them
+static void ss_ctr_fill(uint8_t *keystream, uint8_t *ctr, size_t block_bytes, unsigned counter_bytes,
+                        size_t nblocks)
+{
+    if (block_bytes < 8 || counter_bytes > 8)
+    {
+        for (size_t i = 0; i < nblocks; i++)
+        {
+            memcpy(keystream + i * block_bytes, ctr, block_bytes);
+            ss_ctr_add(ctr, block_bytes, counter_bytes, 1);
+        }
+        return;
+    }
+
+    uint64_t tail = __builtin_bswap64(ss_load_le(ctr + block_bytes - 8, 8));
+    uint64_t mask = counter_bytes == 8 ? UINT64_MAX : ((uint64_t)1 << (8 * counter_bytes)) - 1;
+    // Constant block sizes so the stores compile to single moves
+    switch (block_bytes)
+    {
+    case 8:
+        ss_ctr_fill_tail(keystream, ctr, 8, tail, mask, nblocks);
+        break;
+    case 12:
+        ss_ctr_fill_tail(keystream, ctr, 12, tail, mask, nblocks);
+        break;
+    default:
+        ss_ctr_fill_tail(keystream, ctr, 16, tail, mask, nblocks);
+        break;
+    }
+    tail = (tail & ~mask) | ((tail + nblocks) & mask);
+    ss_store_le(ctr + block_bytes - 8, __builtin_bswap64(tail), 8);
+}
+
+void ss_ctr_xor(const simonspeck_ctx *ctx, uint8_t *ctr, unsigned counter_bytes,
+                const uint8_t *in, uint8_t *out, size_t len)
+{
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t keystream[SS_BATCH_BYTES];
+    size_t block_bytes = ss_block_bytes(ctx);
+    size_t batch = SS_BATCH_BYTES / block_bytes;
+
+    while (len > 0)
+    {
+        size_t nblocks = (len + block_bytes - 1) / block_bytes;
+        if (nblocks > batch)
+        {
+            nblocks = batch;
+        }
+
+        ss_ctr_fill(keystream, ctr, block_bytes, counter_bytes, nblocks);
+        ss_encrypt_blocks(ctx, keystream, keystream, nblocks);
+
+        size_t n = nblocks * block_bytes < len ? nblocks * block_bytes : len;
+        ss_xor(out, in, keystream, n);
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+int simonspeck_ctr(const simonspeck_ctx *ctx, const uint8_t *iv, unsigned counter_bytes,
+                   const uint8_t *in, uint8_t *out, size_t len)
+{
+    uint8_t ctr[16];
+    size_t block_bytes = ss_block_bytes(ctx);
+
+    if (counter_bytes == 0 || counter_bytes > block_bytes)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+    if (ss_ctr_blocks_left(iv, block_bytes, counter_bytes) < (len + block_bytes - 1) / block_bytes)
+    {
+        return SIMONSPECK_ERANGE;
+    }
+
+    memcpy(ctr, iv, block_bytes);
+    ss_ctr_xor(ctx, ctr, counter_bytes, in, out, len);
+    return SIMONSPECK_OK;
+}
+
+void ss_ctr_stream_start(struct simonspeck_ctr_stream *s, const simonspeck_ctx *ctx, const uint8_t *ctr,
+                         unsigned counter_bytes, uint64_t blocks_left)
+{
+    size_t block_bytes = ss_block_bytes(ctx);
+
+    s->ctx = ctx;
+    s->counter_bytes = counter_bytes;
+    s->used = block_bytes;
+    s->blocks_left = blocks_left;
+    memcpy(s->ctr, ctr, block_bytes);
+}
+
+simonspeck_ctr_stream *simonspeck_ctr_stream_new(const simonspeck_ctx *ctx)
+{
+    simonspeck_ctr_stream *s = calloc(1, sizeof(*s));
+    if (s != NULL)
+    {
+        s->ctx = ctx;
+        s->used = ss_block_bytes(ctx);
+    }
+    return s;
+}
+
+void simonspeck_ctr_stream_free(simonspeck_ctr_stream *s)
+{
+    if (s == NULL)
+    {
+        return;
+    }
+
+    volatile uint8_t *p = (volatile uint8_t *)s;
+    for (size_t i = 0; i < sizeof(*s); i++)
+    {
+        p[i] = 0;
+    }
+    free(s);
+}
+
+int simonspeck_ctr_stream_init(simonspeck_ctr_stream *s, const uint8_t *iv, unsigned counter_bytes)
+{
+    size_t block_bytes = ss_block_bytes(s->ctx);
+
+    if (counter_bytes == 0 || counter_bytes > block_bytes)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_ctr_stream_start(s, s->ctx, iv, counter_bytes, ss_ctr_blocks_left(iv, block_bytes, counter_bytes));
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_ctr_stream_update(simonspeck_ctr_stream *s, const uint8_t *in, uint8_t *out, size_t len)
+{
+    size_t block_bytes = ss_block_bytes(s->ctx);
+    size_t head = block_bytes - s->used < len ? block_bytes - s->used : len;
+    size_t whole = (len - head) / block_bytes * block_bytes;
+    size_t tail = len - head - whole;
+
+    if (s->blocks_left < whole / block_bytes + (tail != 0))
+    {
+        return SIMONSPECK_ERANGE;
+    }
+
+    // Rest of the buffered keystream block, then whole blocks straight
+    // through, then one fresh block of which only tail bytes are used
+    ss_xor(out, in, s->ks + s->used, head);
+    s->used += head;
+    in += head;
+    out += head;
+
+    ss_ctr_xor(s->ctx, s->ctr, s->counter_bytes, in, out, whole);
+    s->blocks_left -= whole / block_bytes;
+    in += whole;
+    out += whole;
+
+    if (tail != 0)
+    {
+        simonspeck_encrypt(s->ctx, s->ctr, s->ks);
+        ss_ctr_add(s->ctr, block_bytes, s->counter_bytes, 1);
+        s->blocks_left--;
+        ss_xor(out, in, s->ks, tail);
+        s->used = tail;
+    }
+    return SIMONSPECK_OK;
+}
@@ -0,0 +1,419 @@
+/**
+* gcm.c - GCM authenticated encryption
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gf128.h"
+
+// GCM (NIST SP 800-38D) with a 128-bit block Simon or Speck in place of
+// AES. GHASH runs on the POLYVAL code through the byte reversal mapping of
+// RFC 8452, so it shares the carry-less multiply and aggregated reduction.
+// Each batch is hashed right after (seal) or before (open) its keystream
+// xor, while still in cache.
+
+// Plaintext is at most 2^32 - 2 blocks
+#define SS_GCM_MAX_BYTES ((((uint64_t)1 << 32) - 2) * 16)
+
+struct simonspeck_gcm {
+    simonspeck_ctx *ctx;
+    ss_polyval_key h; // mulX(ByteReverse(E(0))) and its powers
+};
+
+simonspeck_gcm *simonspeck_gcm_new(simonspeck_variant_id id, const uint8_t *key)
+{
+    uint8_t block[16] = { 0 };
+
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT || simonspeck_variants[id].block_size != 128)
+    {
+        return NULL;
+    }
+
+    simonspeck_gcm *gcm = malloc(sizeof(*gcm));
+    if (gcm == NULL)
+    {
+        return NULL;
+    }
+    gcm->ctx = simonspeck_new(id, key);
+    if (gcm->ctx == NULL)
+    {
+        free(gcm);
+        return NULL;
+    }
+
+    simonspeck_encrypt(gcm->ctx, block, block);
+    ss_polyval_init(&gcm->h, ss_gf128_mulx(ss_gf128_load_reversed(block)));
+    memset(block, 0, sizeof(block));
+    return gcm;
+}
+
+void simonspeck_gcm_free(simonspeck_gcm *gcm)
+{
+    if (gcm == NULL)
+    {
+        return;
+    }
+
+    simonspeck_free(gcm->ctx);
+    volatile uint8_t *p = (volatile uint8_t *)gcm;
+    for (size_t i = 0; i < sizeof(*gcm); i++)
+    {
+        p[i] = 0;
+    }
+    free(gcm);
+}
+
+// Absorb len bytes, only the last call may be a partial block, which is
+// zero padded
+static void ss_gcm_hash(const simonspeck_gcm *gcm, ss_gf128 *acc, const uint8_t *p, size_t len)
+{
+    ss_ghash_blocks(&gcm->h, acc, p, len / 16);
+    if (len % 16 != 0)
+    {
+        uint8_t block[16] = { 0 };
+        memcpy(block, p + len - len % 16, len % 16);
+        ss_ghash_blocks(&gcm->h, acc, block, 1);
+    }
+}
+
+// J0 = IV || 0^31 || 1 for 96-bit IVs, GHASH(IV || 0* || [len(IV)]_64)
+// otherwise
+static void ss_gcm_j0(const simonspeck_gcm *gcm, const uint8_t *iv, size_t iv_len, uint8_t *j0)
+{
+    if (iv_len == 12)
+    {
+        memcpy(j0, iv, 12);
+        j0[12] = j0[13] = j0[14] = 0;
+        j0[15] = 1;
+        return;
+    }
+
+    uint8_t block[16] = { 0 };
+    ss_gf128 acc = { 0, 0 };
+    ss_gcm_hash(gcm, &acc, iv, iv_len);
+    for (int i = 0; i < 8; i++)
+    {
+        block[15 - i] = (uint8_t)(((uint64_t)iv_len * 8) >> (8 * i));
+    }
+    ss_ghash_blocks(&gcm->h, &acc, block, 1);
+    ss_gf128_store_reversed(j0, acc);
+}
+
+// T = GHASH(A, C, [len(A)]_64 || [len(C)]_64) ^ E(J0)
+static void ss_gcm_tag(const simonspeck_gcm *gcm, ss_gf128 acc, const uint8_t *j0,
+                       uint64_t aad_len, uint64_t len, uint8_t *tag)
+{
+    uint8_t block[16];
+
+    for (int i = 0; i < 8; i++)
+    {
+        block[7 - i] = (uint8_t)((aad_len * 8) >> (8 * i));
+        block[15 - i] = (uint8_t)((len * 8) >> (8 * i));
+    }
+    ss_ghash_blocks(&gcm->h, &acc, block, 1);
+    ss_gf128_store_reversed(tag, acc);
+    simonspeck_encrypt(gcm->ctx, j0, block);
+    ss_xor(tag, tag, block, 16);
+}
+
+enum {
+    SS_GCM_AAD,
+    SS_GCM_DATA,
+    SS_GCM_DONE
+};
+
+struct simonspeck_gcm_stream {
+    const simonspeck_gcm *gcm;
+    struct simonspeck_ctr_stream ctr;
+    ss_gf128 acc;
+    uint64_t aad_len, len;
+    size_t pending; // GHASH input bytes in buf
+    int decrypt;
+    int state;
+    uint8_t j0[16];
+    uint8_t buf[16];
+};
+
+// volatile so the wipe is not dropped as a dead store before returning
+static void ss_gcm_wipe(void *buf, size_t len)
+{
+    volatile uint8_t *p = buf;
+    for (size_t i = 0; i < len; i++)
+    {
+        p[i] = 0;
+    }
+}
+
+// GHASH input of any length, a partial block waits in buf
+static void ss_gcm_absorb(simonspeck_gcm_stream *s, const uint8_t *p, size_t len)
+{
+    if (s->pending != 0)
+    {
+        size_t n = 16 - s->pending < len ? 16 - s->pending : len;
+        memcpy(s->buf + s->pending, p, n);
+        s->pending += n;
+        p += n;
+        len -= n;
+        if (s->pending < 16)
+        {
+            return;
+        }
+        ss_ghash_blocks(&s->gcm->h, &s->acc, s->buf, 1);
+    }
+
+    ss_ghash_blocks(&s->gcm->h, &s->acc, p, len / 16);
+    s->pending = len % 16;
+    memcpy(s->buf, p + len - s->pending, s->pending);
+}
+
+// Zero pad the end of the additional data or the ciphertext
+static void ss_gcm_pad(simonspeck_gcm_stream *s)
+{
+    if (s->pending != 0)
+    {
+        memset(s->buf + s->pending, 0, 16 - s->pending);
+        ss_ghash_blocks(&s->gcm->h, &s->acc, s->buf, 1);
+        s->pending = 0;
+    }
+}
+
+static int ss_gcm_start(simonspeck_gcm_stream *s, const simonspeck_gcm *gcm, const uint8_t *iv, size_t iv_len,
+                        int decrypt)
+{
+    uint8_t ctr[16];
+
+    if (iv_len == 0)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+    if ((uint64_t)iv_len > UINT64_MAX / 8)
+    {
+        return SIMONSPECK_ERANGE;
+    }
+
+    s->gcm = gcm;
+    s->acc.lo = s->acc.hi = 0;
+    s->aad_len = s->len = 0;
+    s->pending = 0;
+    s->decrypt = decrypt;
+    s->state = SS_GCM_AAD;
+
+    ss_gcm_j0(gcm, iv, iv_len, s->j0);
+    memcpy(ctr, s->j0, 16);
+    ss_ctr_add(ctr, 16, 4, 1);
+    ss_ctr_stream_start(&s->ctr, gcm->ctx, ctr, 4, SS_GCM_MAX_BYTES / 16);
+    return SIMONSPECK_OK;
+}
+
+simonspeck_gcm_stream *simonspeck_gcm_stream_new(const simonspeck_gcm *gcm)
+{
+    simonspeck_gcm_stream *s = calloc(1, sizeof(*s));
+    if (s != NULL)
+    {
+        s->gcm = gcm;
+        s->state = SS_GCM_DONE;
+    }
+    return s;
+}
+
+void simonspeck_gcm_stream_free(simonspeck_gcm_stream *s)
+{
+    if (s == NULL)
+    {
+        return;
+    }
+
+    volatile uint8_t *p = (volatile uint8_t *)s;
+    for (size_t i = 0; i < sizeof(*s); i++)
+    {
+        p[i] = 0;
+    }
+    free(s);
+}
+
+int simonspeck_gcm_stream_init(simonspeck_gcm_stream *s, const uint8_t *iv, size_t iv_len, int decrypt)
+{
+    return ss_gcm_start(s, s->gcm, iv, iv_len, decrypt);
+}
+
+int simonspeck_gcm_stream_aad(simonspeck_gcm_stream *s, const uint8_t *aad, size_t aad_len)
+{
+    if (s->state != SS_GCM_AAD)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+    if ((uint64_t)aad_len > UINT64_MAX / 8 - s->aad_len)
+    {
+        return SIMONSPECK_ERANGE;
+    }
+
+    ss_gcm_absorb(s, aad, aad_len);
+    s->aad_len += aad_len;
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_gcm_stream_update(simonspeck_gcm_stream *s, const uint8_t *in, uint8_t *out, size_t len)
+{
+    if (s->state == SS_GCM_DONE)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+    if ((uint64_t)len > SS_GCM_MAX_BYTES - s->len)
+    {
+        return SIMONSPECK_ERANGE;
+    }
+    if (s->state == SS_GCM_AAD)
+    {
+        ss_gcm_pad(s);
+        s->state = SS_GCM_DATA;
+    }
+
+    // GHASH always reads the ciphertext side, before the keystream xor on
+    // open and after it on seal
+    for (size_t done = 0; done < len; done += SS_BATCH_BYTES)
+    {
+        size_t n = len - done < SS_BATCH_BYTES ? len - done : SS_BATCH_BYTES;
+        if (s->decrypt)
+        {
+            ss_gcm_absorb(s, in + done, n);
+        }
+        simonspeck_ctr_stream_update(&s->ctr, in + done, out + done, n);
+        if (!s->decrypt)
+        {
+            ss_gcm_absorb(s, out + done, n);
+        }
+    }
+    s->len += len;
+    return SIMONSPECK_OK;
+}
+
+// Full 16-byte tag, ends the message
+static int ss_gcm_finish(simonspeck_gcm_stream *s, int decrypt, size_t tag_len, uint8_t *tag)
+{
+    if (s->state == SS_GCM_DONE || s->decrypt != decrypt || tag_len < 4 || tag_len > 16)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_gcm_pad(s);
+    ss_gcm_tag(s->gcm, s->acc, s->j0, s->aad_len, s->len, tag);
+    s->state = SS_GCM_DONE;
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_gcm_stream_final(simonspeck_gcm_stream *s, uint8_t *tag, size_t tag_len)
+{
+    uint8_t full[16];
+
+    int ret = ss_gcm_finish(s, 0, tag_len, full);
+    if (ret == SIMONSPECK_OK)
+    {
+        memcpy(tag, full, tag_len);
+    }
+    return ret;
+}
+
+int simonspeck_gcm_stream_verify(simonspeck_gcm_stream *s, const uint8_t *tag, size_t tag_len)
+{
+    uint8_t full[16];
+
+    int ret = ss_gcm_finish(s, 1, tag_len, full);
+    if (ret != SIMONSPECK_OK)
+    {
+        return ret;
+    }
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < tag_len; i++)
+    {
+        diff |= full[i] ^ tag[i];
+    }
+    // The expected tag would let anyone who reads it forge this message
+    ss_gcm_wipe(full, sizeof(full));
+    return diff == 0 ? SIMONSPECK_OK : SIMONSPECK_EAUTH;
+}
+
+// One-shot calls run a stream on the stack, wiped before they return: it
+// holds keystream, the GHASH state and J0
+static int ss_gcm_crypt(const simonspeck_gcm *gcm, const uint8_t *iv, size_t iv_len,
+                        const uint8_t *aad, size_t aad_len, const uint8_t *in, uint8_t *out, size_t len,
+                        simonspeck_gcm_stream *s, int decrypt)
+{
+    int ret = ss_gcm_start(s, gcm, iv, iv_len, decrypt);
+    if (ret == SIMONSPECK_OK)
+    {
+        ret = simonspeck_gcm_stream_aad(s, aad, aad_len);
+    }
+    if (ret == SIMONSPECK_OK)
+    {
+        ret = simonspeck_gcm_stream_update(s, in, out, len);
+    }
+    return ret;
+}
+
+int simonspeck_gcm_seal(const simonspeck_gcm *gcm, const uint8_t *iv, size_t iv_len,
+                        const uint8_t *aad, size_t aad_len, const uint8_t *in, uint8_t *out, size_t len,
+                        uint8_t *tag, size_t tag_len)
+{
+    simonspeck_gcm_stream s;
+
+    if (tag_len < 4 || tag_len > 16)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    int ret = ss_gcm_crypt(gcm, iv, iv_len, aad, aad_len, in, out, len, &s, 0);
+    if (ret == SIMONSPECK_OK)
+    {
+        ret = simonspeck_gcm_stream_final(&s, tag, tag_len);
+    }
+    ss_gcm_wipe(&s, sizeof(s));
+    return ret;
+}
+
+int simonspeck_gcm_open(const simonspeck_gcm *gcm, const uint8_t *iv, size_t iv_len,
+                        const uint8_t *aad, size_t aad_len, const uint8_t *in, uint8_t *out, size_t len,
+                        const uint8_t *tag, size_t tag_len)
+{
+    simonspeck_gcm_stream s;
+
+    if (tag_len < 4 || tag_len > 16)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    int ret = ss_gcm_crypt(gcm, iv, iv_len, aad, aad_len, in, out, len, &s, 1);
+    if (ret == SIMONSPECK_OK)
+    {
+        ret = simonspeck_gcm_stream_verify(&s, tag, tag_len);
+    }
+    if (ret == SIMONSPECK_EAUTH)
+    {
+        ss_gcm_wipe(out, len);
+    }
+    ss_gcm_wipe(&s, sizeof(s));
+    return ret;
+}
@@ -0,0 +1,168 @@
+/**
+* gf128.h - GF(2^128) arithmetic for POLYVAL
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_GF128_H
+#define SIMONSPECK_GF128_H
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+// Field element, bit i of the 128-bit little endian value is the
+// coefficient of x^i (POLYVAL convention)
+typedef struct {
+    uint64_t lo, hi;
+} ss_gf128;
+
+SS_INLINE ss_gf128 ss_gf128_load(const uint8_t *p)
+{
+    ss_gf128 a = { ss_load_le(p, 8), ss_load_le(p + 8, 8) };
+    return a;
+}
+
+SS_INLINE void ss_gf128_store(uint8_t *p, ss_gf128 a)
+{
+    ss_store_le(p, a.lo, 8);
+    ss_store_le(p + 8, a.hi, 8);
+}
+
+// GHASH blocks are the byte reversal of POLYVAL ones (RFC 8452 appendix A)
+SS_INLINE ss_gf128 ss_gf128_load_reversed(const uint8_t *p)
+{
+    ss_gf128 a = { __builtin_bswap64(ss_load_le(p + 8, 8)), __builtin_bswap64(ss_load_le(p, 8)) };
+    return a;
+}
+
+SS_INLINE void ss_gf128_store_reversed(uint8_t *p, ss_gf128 a)
+{
+    ss_store_le(p, __builtin_bswap64(a.hi), 8);
+    ss_store_le(p + 8, __builtin_bswap64(a.lo), 8);
+}
+
+// a * x, the GHASH key H maps to mulX(ByteReverse(H)) in POLYVAL
+SS_INLINE ss_gf128 ss_gf128_mulx(ss_gf128 a)
+{
+    uint64_t carry = 0 - (a.hi >> 63);
+    ss_gf128 r = { (a.lo << 1) ^ (carry & 1), (a.hi << 1) ^ (a.lo >> 63) ^ (carry & 0xc200000000000000) };
+    return r;
+}
+
+// Low 64 bits of the carry-less product, constant time: integer multiplies
+// on operands with every fourth bit kept, so carries land in masked holes
+SS_INLINE uint64_t ss_bmul64(uint64_t x, uint64_t y)
+{
+    const uint64_t m0 = 0x1111111111111111, m1 = 0x2222222222222222;
+    const uint64_t m2 = 0x4444444444444444, m3 = 0x8888888888888888;
+    uint64_t x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+    uint64_t y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+SS_INLINE uint64_t ss_rev64(uint64_t x)
+{
+    x = ((x & 0x5555555555555555) << 1) | ((x >> 1) & 0x5555555555555555);
+    x = ((x & 0x3333333333333333) << 2) | ((x >> 2) & 0x3333333333333333);
+    x = ((x & 0x0F0F0F0F0F0F0F0F) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0F);
+    return __builtin_bswap64(x);
+}
+
+// Full 128-bit carry-less product of two 64-bit values
+SS_INLINE ss_gf128 ss_clmul64(uint64_t x, uint64_t y)
+{
+    ss_gf128 r;
+    r.lo = ss_bmul64(x, y);
+    r.hi = ss_rev64(ss_bmul64(ss_rev64(x), ss_rev64(y))) >> 1;
+    return r;
+}
+
+// Unreduced 256-bit product, Karatsuba
+typedef struct {
+    ss_gf128 lo, hi;
+} ss_gf256;
+
+SS_INLINE ss_gf256 ss_gf128_mul_wide(ss_gf128 a, ss_gf128 b)
+{
+    ss_gf128 lo = ss_clmul64(a.lo, b.lo);
+    ss_gf128 hi = ss_clmul64(a.hi, b.hi);
+    ss_gf128 mid = ss_clmul64(a.lo ^ a.hi, b.lo ^ b.hi);
+    mid.lo ^= lo.lo ^ hi.lo;
+    mid.hi ^= lo.hi ^ hi.hi;
+    ss_gf256 r = { { lo.lo, lo.hi ^ mid.lo }, { hi.lo ^ mid.hi, hi.hi } };
+    return r;
+}
+
+// d * x^-128 mod x^128 + x^127 + x^126 + x^121 + 1, two Montgomery folds
+// of 64 bits each
+SS_INLINE ss_gf128 ss_polyval_reduce(ss_gf256 d)
+{
+    const uint64_t poly = 0xc200000000000000;
+    ss_gf128 t = ss_clmul64(d.lo.lo, poly);
+    ss_gf128 x = { d.lo.hi ^ t.lo, d.lo.lo ^ t.hi };
+    t = ss_clmul64(x.lo, poly);
+    ss_gf128 r = { d.hi.lo ^ x.hi ^ t.lo, d.hi.hi ^ x.lo ^ t.hi };
+    return r;
+}
+
+// POLYVAL dot(a, b) = a * b * x^-128
+SS_INLINE ss_gf128 ss_polyval_dot(ss_gf128 a, ss_gf128 b)
+{
+    return ss_polyval_reduce(ss_gf128_mul_wide(a, b));
+}
+
+// polyval.c: POLYVAL with the powers h, h^2, h^3, h^4 for aggregated
+// reduction, absorbing nblocks full 16-byte blocks into acc. ss_ghash_blocks
+// takes GHASH blocks under the mapped key, acc then holds the byte reversed
+// GHASH state. ss_polyval_init picks the multiply for this CPU.
+typedef struct ss_polyval_key ss_polyval_key;
+typedef void (*ss_polyval_blocks_fn)(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in,
+                                     size_t nblocks);
+
+struct ss_polyval_key {
+    ss_gf128 h[4];
+    ss_polyval_blocks_fn polyval, ghash;
+};
+
+void ss_polyval_init(ss_polyval_key *key, ss_gf128 h);
+
+SS_INLINE void ss_polyval_blocks(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks)
+{
+    key->polyval(key, acc, in, nblocks);
+}
+
+SS_INLINE void ss_ghash_blocks(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks)
+{
+    key->ghash(key, acc, in, nblocks);
+}
+
+// polyval_pclmul.c, x86-64
+void ss_polyval_blocks_pclmul(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks);
+void ss_ghash_blocks_pclmul(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks);
+
+#endif
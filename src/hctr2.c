@@ -0,0 +1,198 @@
+/**
+* hctr2.c - HCTR2 wide-block tweakable mode
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gf128.h"
+
+// HCTR2 (Crowley, Huckleberry, Biggers) with a 128-bit block Simon or
+// Speck in place of AES. The second hash pass runs over each XCTR batch
+// while it is still in cache.
+
+struct simonspeck_hctr2 {
+    simonspeck_ctx *ctx;
+    ss_polyval_key h; // E(bin(0)) and its powers
+    uint8_t L[16]; // E(bin(1))
+};
+
+simonspeck_hctr2 *simonspeck_hctr2_new(simonspeck_variant_id id, const uint8_t *key)
+{
+    uint8_t block[16] = { 0 };
+
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT || simonspeck_variants[id].block_size != 128)
+    {
+        return NULL;
+    }
+
+    simonspeck_hctr2 *hctr2 = malloc(sizeof(*hctr2));
+    if (hctr2 == NULL)
+    {
+        return NULL;
+    }
+    hctr2->ctx = simonspeck_new(id, key);
+    if (hctr2->ctx == NULL)
+    {
+        free(hctr2);
+        return NULL;
+    }
+
+    simonspeck_encrypt(hctr2->ctx, block, block);
+    ss_polyval_init(&hctr2->h, ss_gf128_load(block));
+    memset(block, 0, sizeof(block));
+    block[0] = 1;
+    simonspeck_encrypt(hctr2->ctx, block, hctr2->L);
+    return hctr2;
+}
+
+void simonspeck_hctr2_free(simonspeck_hctr2 *hctr2)
+{
+    if (hctr2 == NULL)
+    {
+        return;
+    }
+
+    simonspeck_free(hctr2->ctx);
+    volatile uint8_t *p = (volatile uint8_t *)hctr2;
+    for (size_t i = 0; i < sizeof(*hctr2); i++)
+    {
+        p[i] = 0;
+    }
+    free(hctr2);
+}
+
+// POLYVAL state after bin(2|T| + 2 + has_remainder) || pad(T)
+static ss_gf128 ss_hctr2_hash_tweak(const simonspeck_hctr2 *hctr2, const uint8_t *tweak, size_t tweak_len,
+                                    int has_remainder)
+{
+    uint8_t block[16] = { 0 };
+    ss_gf128 acc = { 0, 0 };
+
+    ss_store_le(block, 16 * (uint64_t)tweak_len + 2 + has_remainder, 8);
+    ss_polyval_blocks(&hctr2->h, &acc, block, 1);
+
+    ss_polyval_blocks(&hctr2->h, &acc, tweak, tweak_len / 16);
+    if (tweak_len % 16 != 0)
+    {
+        memset(block, 0, sizeof(block));
+        memcpy(block, tweak + tweak_len - tweak_len % 16, tweak_len % 16);
+        ss_polyval_blocks(&hctr2->h, &acc, block, 1);
+    }
+    return acc;
+}
+
+// Absorb message bytes, only the last call may be a partial block, which
+// is padded as M || 1 || 0*
+static void ss_hctr2_hash_message(const simonspeck_hctr2 *hctr2, ss_gf128 *acc, const uint8_t *msg, size_t len)
+{
+    ss_polyval_blocks(&hctr2->h, acc, msg, len / 16);
+    if (len % 16 != 0)
+    {
+        uint8_t block[16] = { 0 };
+        memcpy(block, msg + len - len % 16, len % 16);
+        block[len % 16] = 0x01;
+        ss_polyval_blocks(&hctr2->h, acc, block, 1);
+    }
+}
+
+// XCTR keystream E(S ^ bin(i)) for i = index, index + 1, ..., over at most
+// SS_BATCH_BYTES
+static void ss_hctr2_xctr(const simonspeck_ctx *ctx, const uint8_t *S, uint64_t index,
+                          const uint8_t *in, uint8_t *out, size_t len)
+{
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t keystream[SS_BATCH_BYTES];
+    size_t nblocks = (len + 15) / 16;
+    uint64_t s = ss_load_le(S, 8);
+
+    for (size_t i = 0; i < nblocks; i++)
+    {
+        ss_store_le(keystream + 16 * i, s ^ (index + i), 8);
+        memcpy(keystream + 16 * i + 8, S + 8, 8);
+    }
+    ss_encrypt_blocks(ctx, keystream, keystream, nblocks);
+    ss_xor(out, in, keystream, len);
+}
+
+static int ss_hctr2_crypt(const simonspeck_hctr2 *hctr2, const uint8_t *tweak, size_t tweak_len,
+                          const uint8_t *in, uint8_t *out, size_t len, int decrypt)
+{
+    uint8_t head[16], hashed[16], crypted[16], S[16];
+
+    if (len < 16)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    size_t tail_len = len - 16;
+    ss_gf128 base = ss_hctr2_hash_tweak(hctr2, tweak, tweak_len, tail_len % 16 != 0);
+    ss_gf128 acc = base;
+
+    // Encrypt: UU = M ^ H(T, N), UUU = E(UU)
+    // Decrypt: UUU = U ^ H(T, V), UU = D(UUU)
+    memcpy(head, in, 16);
+    ss_hctr2_hash_message(hctr2, &acc, in + 16, tail_len);
+    ss_gf128_store(hashed, acc);
+    ss_xor(hashed, hashed, head, 16);
+    if (decrypt)
+    {
+        simonspeck_decrypt(hctr2->ctx, hashed, crypted);
+    }
+    else
+    {
+        simonspeck_encrypt(hctr2->ctx, hashed, crypted);
+    }
+
+    // S = UU ^ UUU ^ L
+    ss_xor(S, hashed, crypted, 16);
+    ss_xor(S, S, hctr2->L, 16);
+
+    // V = N ^ XCTR(S) (or N from V), hashing the plaintext side's
+    // counterpart batch by batch
+    acc = base;
+    for (size_t done = 0; done < tail_len; done += SS_BATCH_BYTES)
+    {
+        size_t n = tail_len - done < SS_BATCH_BYTES ? tail_len - done : SS_BATCH_BYTES;
+        ss_hctr2_xctr(hctr2->ctx, S, 1 + done / 16, in + 16 + done, out + 16 + done, n);
+        ss_hctr2_hash_message(hctr2, &acc, out + 16 + done, n);
+    }
+
+    // Encrypt: U = UUU ^ H(T, V), decrypt: M = UU ^ H(T, N)
+    ss_gf128_store(head, acc);
+    ss_xor(out, head, crypted, 16);
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_hctr2_encrypt(const simonspeck_hctr2 *hctr2, const uint8_t *tweak, size_t tweak_len,
+                             const uint8_t *in, uint8_t *out, size_t len)
+{
+    return ss_hctr2_crypt(hctr2, tweak, tweak_len, in, out, len, 0);
+}
+
+int simonspeck_hctr2_decrypt(const simonspeck_hctr2 *hctr2, const uint8_t *tweak, size_t tweak_len,
+                             const uint8_t *in, uint8_t *out, size_t len)
+{
+    return ss_hctr2_crypt(hctr2, tweak, tweak_len, in, out, len, 1);
+}
@@ -0,0 +1,302 @@
+/**
+* jit.c - Key specialized x86-64 kernels generated at runtime
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+
+// An AVX2 Speck128 encryption kernel for one key: all rounds unrolled for
+// two register pairs, eight blocks per iteration, each round key a
+// broadcast constant next to the code. The mapping is written, then made
+// read and execute only. Simon128 is not compiled: its generated code ran
+// slower than the ss_simon128_avx2 kernel, which interleaves more blocks.
+//
+// Layout: the byte shuffle for the rotation by 8, one 32-byte row per
+// round key, then the code. Entry follows ss_kernel_fn: rdx in, rcx out,
+// r8 nblocks, rax the blocks done.
+
+#define SS_JIT_RIP 16 // memory operand base: RIP relative, else rcx or rdx
+#define SS_JIT_RCX 1
+#define SS_JIT_RDX 2
+
+struct ss_jit {
+    uint8_t *p; // start of the mapping
+    size_t n;   // bytes written
+};
+
+static void ss_jit_byte(struct ss_jit *j, unsigned b)
+{
+    j->p[j->n++] = (uint8_t)b;
+}
+
+static void ss_jit_u32(struct ss_jit *j, uint32_t v)
+{
+    for (unsigned i = 0; i < 4; i++)
+    {
+        ss_jit_byte(j, v >> (8 * i));
+    }
+}
+
+// VEX.256 prefix, three byte form. map 1 = 0F, 2 = 0F38. pp 1 = 66, 2 = F3.
+static void ss_jit_vex(struct ss_jit *j, unsigned map, unsigned pp, unsigned op,
+                       unsigned reg, unsigned vvvv, unsigned rm_high)
+{
+    ss_jit_byte(j, 0xc4);
+    ss_jit_byte(j, (~reg & 8) << 4 | 0x40 | (~rm_high & 1) << 5 | map);
+    ss_jit_byte(j, (~vvvv & 15) << 3 | 4 | pp);
+    ss_jit_byte(j, op);
+}
+
+// reg = op(vvvv, rm), all ymm registers
+static void ss_jit_rr(struct ss_jit *j, unsigned map, unsigned op, unsigned reg, unsigned vvvv, unsigned rm)
+{
+    ss_jit_vex(j, map, 1, op, reg, vvvv, rm >> 3);
+    ss_jit_byte(j, 0xc0 | (reg & 7) << 3 | (rm & 7));
+}
+
+// reg = op(vvvv, [base + disp]), disp from the start of the mapping for RIP
+static void ss_jit_rm(struct ss_jit *j, unsigned pp, unsigned op, unsigned reg, unsigned vvvv,
+                      unsigned base, int32_t disp)
+{
+    ss_jit_vex(j, 1, pp, op, reg, vvvv, 0);
+    if (base == SS_JIT_RIP)
+    {
+        ss_jit_byte(j, (reg & 7) << 3 | 5);
+        ss_jit_u32(j, (uint32_t)(disp - (int32_t)(j->n + 4)));
+    }
+    else
+    {
+        ss_jit_byte(j, 0x80 | (reg & 7) << 3 | base);
+        ss_jit_u32(j, (uint32_t)disp);
+    }
+}
+
+// vpsllq / vpsrlq reg, rm, imm: 73 /6 and 73 /2
+static void ss_jit_shift(struct ss_jit *j, unsigned ext, unsigned reg, unsigned rm, unsigned imm)
+{
+    ss_jit_vex(j, 1, 1, 0x73, 0, reg, rm >> 3);
+    ss_jit_byte(j, 0xc0 | ext << 3 | (rm & 7));
+    ss_jit_byte(j, imm);
+}
+
+#define SS_JIT_PADDQ(j, d, a, b) ss_jit_rr(j, 1, 0xd4, d, a, b)
+#define SS_JIT_PXOR(j, d, a, b) ss_jit_rr(j, 1, 0xef, d, a, b)
+#define SS_JIT_POR(j, d, a, b) ss_jit_rr(j, 1, 0xeb, d, a, b)
+#define SS_JIT_PSHUFB(j, d, a, b) ss_jit_rr(j, 2, 0x00, d, a, b)
+#define SS_JIT_PUNPCKLQDQ(j, d, a, b) ss_jit_rr(j, 1, 0x6c, d, a, b)
+#define SS_JIT_PUNPCKHQDQ(j, d, a, b) ss_jit_rr(j, 1, 0x6d, d, a, b)
+#define SS_JIT_PSLLQ(j, d, a, imm) ss_jit_shift(j, 6, d, a, imm)
+#define SS_JIT_PSRLQ(j, d, a, imm) ss_jit_shift(j, 2, d, a, imm)
+#define SS_JIT_PXOR_KEY(j, d, i) ss_jit_rm(j, 1, 0xef, d, d, SS_JIT_RIP, 32 * ((int32_t)(i) + 1))
+#define SS_JIT_LOAD(j, d, base, disp) ss_jit_rm(j, 2, 0x6f, d, 0, base, disp)
+#define SS_JIT_STORE(j, s, base, disp) ss_jit_rm(j, 2, 0x7f, s, 0, base, disp)
+
+// ymm0 holds the byte shuffle, pair p uses x, y and three temporaries
+struct ss_jit_pair {
+    unsigned x, y, t0, t1, t2;
+};
+
+static const struct ss_jit_pair ss_jit_pairs[2] = {
+    {1, 2, 5, 6, 7},
+    {3, 4, 8, 9, 10},
+};
+
+static void ss_jit_speck_round(struct ss_jit *j, const struct ss_jit_pair *r, unsigned i)
+{
+    SS_JIT_PSHUFB(j, r->x, r->x, 0);
+    SS_JIT_PADDQ(j, r->x, r->x, r->y);
+    SS_JIT_PXOR_KEY(j, r->x, i);
+    SS_JIT_PSLLQ(j, r->t0, r->y, 3);
+    SS_JIT_PSRLQ(j, r->y, r->y, 61);
+    SS_JIT_POR(j, r->y, r->y, r->t0);
+    SS_JIT_PXOR(j, r->y, r->y, r->x);
+}
+
+static void ss_jit_emit(struct ss_jit *j, const simonspeck_ctx *ctx)
+{
+    static const uint8_t ror8[16] = {1, 2, 3, 4, 5, 6, 7, 0, 9, 10, 11, 12, 13, 14, 15, 8};
+    const uint64_t *k = (const uint64_t *)ctx->schedule;
+    unsigned rounds = ctx->variant->rounds;
+    const struct ss_jit_pair *r = ss_jit_pairs;
+
+    memcpy(j->p, ror8, 16);
+    memcpy(j->p + 16, ror8, 16);
+    for (unsigned i = 0; i < rounds; i++)
+    {
+        for (unsigned l = 0; l < 4; l++)
+        {
+            memcpy(j->p + 32 * (i + 1) + 8 * l, &k[i], 8);
+        }
+    }
+    j->n = 32 * (rounds + 1);
+
+    SS_JIT_LOAD(j, 0, SS_JIT_RIP, 0);
+    ss_jit_byte(j, 0x31); // xor eax, eax
+    ss_jit_byte(j, 0xc0);
+
+    size_t top = j->n;
+    ss_jit_byte(j, 0x49); // cmp r8, 8
+    ss_jit_byte(j, 0x83);
+    ss_jit_byte(j, 0xf8);
+    ss_jit_byte(j, 8);
+    ss_jit_byte(j, 0x0f); // jb done
+    ss_jit_byte(j, 0x82);
+    size_t jb = j->n;
+    ss_jit_u32(j, 0);
+
+    for (unsigned p = 0; p < 2; p++)
+    {
+        SS_JIT_LOAD(j, r[p].t0, SS_JIT_RDX, 64 * p);
+        SS_JIT_LOAD(j, r[p].t1, SS_JIT_RDX, 64 * p + 32);
+        SS_JIT_PUNPCKLQDQ(j, r[p].y, r[p].t0, r[p].t1);
+        SS_JIT_PUNPCKHQDQ(j, r[p].x, r[p].t0, r[p].t1);
+    }
+
+    for (unsigned i = 0; i < rounds; i++)
+    {
+        for (unsigned p = 0; p < 2; p++)
+        {
+            ss_jit_speck_round(j, &r[p], i);
+        }
+    }
+
+    for (unsigned p = 0; p < 2; p++)
+    {
+        SS_JIT_PUNPCKLQDQ(j, r[p].t0, r[p].y, r[p].x);
+        SS_JIT_PUNPCKHQDQ(j, r[p].t1, r[p].y, r[p].x);
+        SS_JIT_STORE(j, r[p].t0, SS_JIT_RCX, 64 * p);
+        SS_JIT_STORE(j, r[p].t1, SS_JIT_RCX, 64 * p + 32);
+    }
+
+    static const uint8_t step[] = {
+        0x48, 0x81, 0xc2, 128, 0, 0, 0, // add rdx, 128
+        0x48, 0x81, 0xc1, 128, 0, 0, 0, // add rcx, 128
+        0x48, 0x83, 0xc0, 8,             // add rax, 8
+        0x49, 0x83, 0xe8, 8,             // sub r8, 8
+    };
+    memcpy(j->p + j->n, step, sizeof(step));
+    j->n += sizeof(step);
+    ss_jit_byte(j, 0xe9); // jmp top
+    ss_jit_u32(j, (uint32_t)((int32_t)top - (int32_t)(j->n + 4)));
+
+    uint32_t done = (uint32_t)(j->n - (jb + 4));
+    memcpy(j->p + jb, &done, 4);
+    ss_jit_byte(j, 0xc5); // vzeroupper
+    ss_jit_byte(j, 0xf8);
+    ss_jit_byte(j, 0x77);
+    ss_jit_byte(j, 0xc3); // ret
+}
+
+static size_t ss_jit_decrypt_none(const void *schedule, unsigned rounds,
+                                  const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    (void)schedule, (void)rounds, (void)in, (void)out, (void)nblocks;
+    return 0;
+}
+
+int ss_jit_compile(simonspeck_ctx *ctx)
+{
+    const simonspeck_variant *variant = ctx->variant;
+    const char *env = getenv("SIMONSPECK_JIT");
+
+    if (variant->cipher != SIMONSPECK_SPECK || variant->word_size != 64 || !ss_jit_allowed() ||
+        (env != NULL && strcmp(env, "0") == 0))
+    {
+        ss_jit_release(ctx);
+        return SIMONSPECK_EINVAL;
+    }
+
+    // Pool plus at most 7 instructions of 9 bytes per round and pair,
+    // the loads, stores and loop take well under a kilobyte
+    size_t size = 32 * (variant->rounds + 1) + 2 * 7 * 9 * variant->rounds + 1024;
+    size = (size + 4095) & ~(size_t)4095;
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        ss_jit_release(ctx);
+        return SIMONSPECK_EINVAL;
+    }
+
+    struct ss_jit j = {p, 0};
+    ss_jit_emit(&j, ctx);
+    if (mprotect(p, size, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(p, size);
+        ss_jit_release(ctx);
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_jit_release(ctx);
+    const struct ss_kernel *base = ctx->kernel;
+    ctx->jit = p;
+    ctx->jit_size = size;
+    ctx->jit_kernel.name = "jit";
+    ctx->jit_kernel.encrypt_blocks = (ss_kernel_fn)(uintptr_t)((uint8_t *)p + 32 * (variant->rounds + 1));
+    ctx->jit_kernel.decrypt_blocks = base != NULL ? base->decrypt_blocks : ss_jit_decrypt_none;
+    ctx->kernel = &ctx->jit_kernel;
+    return SIMONSPECK_OK;
+}
+
+void ss_jit_release(simonspeck_ctx *ctx)
+{
+    if (ctx->jit == NULL)
+    {
+        return;
+    }
+
+    // The pool holds the round keys
+    if (mprotect(ctx->jit, ctx->jit_size, PROT_READ | PROT_WRITE) == 0)
+    {
+        volatile uint8_t *p = ctx->jit;
+        for (size_t i = 0; i < ctx->jit_size; i++)
+        {
+            p[i] = 0;
+        }
+    }
+    munmap(ctx->jit, ctx->jit_size);
+    ctx->jit = NULL;
+    ctx->kernel = ss_kernel_for(ctx->variant);
+}
+
+#else
+
+int ss_jit_compile(simonspeck_ctx *ctx)
+{
+    (void)ctx;
+    return SIMONSPECK_EINVAL;
+}
+
+void ss_jit_release(simonspeck_ctx *ctx)
+{
+    (void)ctx;
+}
+
+#endif
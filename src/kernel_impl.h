@@ -0,0 +1,160 @@
+/**
+* kernel_impl.h - SIMD kernel loop template
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+// Included once per kernel with the following defined:
+//   SS_KERNEL        kernel name, e.g. ss_speck128_avx2
+//   SS_KERNEL_TIER   instruction set, e.g. "avx2"
+//   SS_KERNEL_VEC    vector type
+//   SS_KERNEL_LANES  blocks per register pair
+//   SS_KERNEL_BLOCK  block size in bytes
+//   SS_KERNEL_LOAD   load(in, &x, &y), lanes blocks -> word vectors
+//   SS_KERNEL_STORE  store(out, x, y), the inverse
+// optionally, for instruction sets with masked loads and stores:
+//   SS_KERNEL_LOAD_PARTIAL   load_partial(in, n, &x, &y), n < lanes blocks
+//   SS_KERNEL_STORE_PARTIAL  store_partial(out, n, x, y)
+// and these SS_KERNEL_<name> functions:
+//   key(k, i)                              round key i broadcast
+//   round(&x, &y, k), inverse_round(&x, &y, k)
+// Two register pairs are in flight per iteration, then one pair. The rest
+// is one masked pair if the kernel has partial loads, else the scalar
+// code's.
+
+#define SS_KFN(name) SS_CAT(SS_CAT(SS_KERNEL, _), name)
+
+static size_t SS_KFN(encrypt)(const void *schedule, unsigned rounds,
+                              const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    const size_t pair = SS_KERNEL_LANES * SS_KERNEL_BLOCK;
+    size_t done = 0;
+
+    for (; nblocks - done >= 2 * SS_KERNEL_LANES; done += 2 * SS_KERNEL_LANES)
+    {
+        SS_KERNEL_VEC x0, y0, x1, y1;
+        SS_KERNEL_LOAD(in + done * SS_KERNEL_BLOCK, &x0, &y0);
+        SS_KERNEL_LOAD(in + done * SS_KERNEL_BLOCK + pair, &x1, &y1);
+        for (unsigned i = 0; i < rounds; i++)
+        {
+            SS_KERNEL_VEC k = SS_KFN(key)(schedule, i);
+            SS_KFN(round)(&x0, &y0, k);
+            SS_KFN(round)(&x1, &y1, k);
+        }
+        SS_KERNEL_STORE(out + done * SS_KERNEL_BLOCK, x0, y0);
+        SS_KERNEL_STORE(out + done * SS_KERNEL_BLOCK + pair, x1, y1);
+    }
+
+    if (nblocks - done >= SS_KERNEL_LANES)
+    {
+        SS_KERNEL_VEC x0, y0;
+        SS_KERNEL_LOAD(in + done * SS_KERNEL_BLOCK, &x0, &y0);
+        for (unsigned i = 0; i < rounds; i++)
+        {
+            SS_KFN(round)(&x0, &y0, SS_KFN(key)(schedule, i));
+        }
+        SS_KERNEL_STORE(out + done * SS_KERNEL_BLOCK, x0, y0);
+        done += SS_KERNEL_LANES;
+    }
+
+#ifdef SS_KERNEL_LOAD_PARTIAL
+    if (done < nblocks)
+    {
+        SS_KERNEL_VEC x0, y0;
+        SS_KERNEL_LOAD_PARTIAL(in + done * SS_KERNEL_BLOCK, nblocks - done, &x0, &y0);
+        for (unsigned i = 0; i < rounds; i++)
+        {
+            SS_KFN(round)(&x0, &y0, SS_KFN(key)(schedule, i));
+        }
+        SS_KERNEL_STORE_PARTIAL(out + done * SS_KERNEL_BLOCK, nblocks - done, x0, y0);
+        done = nblocks;
+    }
+#endif
+    return done;
+}
+
+static size_t SS_KFN(decrypt)(const void *schedule, unsigned rounds,
+                              const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    const size_t pair = SS_KERNEL_LANES * SS_KERNEL_BLOCK;
+    size_t done = 0;
+
+    for (; nblocks - done >= 2 * SS_KERNEL_LANES; done += 2 * SS_KERNEL_LANES)
+    {
+        SS_KERNEL_VEC x0, y0, x1, y1;
+        SS_KERNEL_LOAD(in + done * SS_KERNEL_BLOCK, &x0, &y0);
+        SS_KERNEL_LOAD(in + done * SS_KERNEL_BLOCK + pair, &x1, &y1);
+        for (unsigned i = rounds; i-- > 0;)
+        {
+            SS_KERNEL_VEC k = SS_KFN(key)(schedule, i);
+            SS_KFN(inverse_round)(&x0, &y0, k);
+            SS_KFN(inverse_round)(&x1, &y1, k);
+        }
+        SS_KERNEL_STORE(out + done * SS_KERNEL_BLOCK, x0, y0);
+        SS_KERNEL_STORE(out + done * SS_KERNEL_BLOCK + pair, x1, y1);
+    }
+
+    if (nblocks - done >= SS_KERNEL_LANES)
+    {
+        SS_KERNEL_VEC x0, y0;
+        SS_KERNEL_LOAD(in + done * SS_KERNEL_BLOCK, &x0, &y0);
+        for (unsigned i = rounds; i-- > 0;)
+        {
+            SS_KFN(inverse_round)(&x0, &y0, SS_KFN(key)(schedule, i));
+        }
+        SS_KERNEL_STORE(out + done * SS_KERNEL_BLOCK, x0, y0);
+        done += SS_KERNEL_LANES;
+    }
+
+#ifdef SS_KERNEL_LOAD_PARTIAL
+    if (done < nblocks)
+    {
+        SS_KERNEL_VEC x0, y0;
+        SS_KERNEL_LOAD_PARTIAL(in + done * SS_KERNEL_BLOCK, nblocks - done, &x0, &y0);
+        for (unsigned i = rounds; i-- > 0;)
+        {
+            SS_KFN(inverse_round)(&x0, &y0, SS_KFN(key)(schedule, i));
+        }
+        SS_KERNEL_STORE_PARTIAL(out + done * SS_KERNEL_BLOCK, nblocks - done, x0, y0);
+        done = nblocks;
+    }
+#endif
+    return done;
+}
+
+const struct ss_kernel SS_KERNEL = {
+    .name = SS_KERNEL_TIER,
+    .encrypt_blocks = SS_KFN(encrypt),
+    .decrypt_blocks = SS_KFN(decrypt),
+};
+
+#undef SS_KFN
+#undef SS_KERNEL
+#undef SS_KERNEL_TIER
+#undef SS_KERNEL_VEC
+#undef SS_KERNEL_LANES
+#undef SS_KERNEL_BLOCK
+#undef SS_KERNEL_LOAD
+#undef SS_KERNEL_STORE
+#undef SS_KERNEL_LOAD_PARTIAL
+#undef SS_KERNEL_STORE_PARTIAL
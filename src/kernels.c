@@ -0,0 +1,270 @@
+/**
+* kernels.c - SIMD kernel selection
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+// The Makefile builds the x86-64 kernels for their instruction set whatever
+// CFLAGS targets, CPUID picks among them at runtime
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SS_X86_DISPATCH 1
+#else
+#define SS_X86_DISPATCH 0
+#endif
+
+// Kernel tiers from slowest to fastest, named like the kernels
+enum {
+    SS_TIER_SCALAR,
+    SS_TIER_BITSLICE,
+    SS_TIER_VEC,
+    SS_TIER_SSSE3,
+    SS_TIER_AVX2,
+    SS_TIER_AVX512,
+    SS_TIER_COUNT
+};
+
+static const char *const ss_tier_names[SS_TIER_COUNT] = {
+    "scalar", "bitslice", "vec", "ssse3", "avx2", "avx512"
+};
+
+#define SS_TIER(t) (1u << (t))
+#define SS_PCLMUL (1u << SS_TIER_COUNT) // carry-less multiply for POLYVAL
+#define SS_VEC64 (1u << (SS_TIER_COUNT + 1)) // vec kernels on 64-bit words
+
+// Tiers this machine runs, capped by SIMONSPECK_TIER=<tier name> if set,
+// e.g. SIMONSPECK_TIER=ssse3 to benchmark the SSSE3 kernels on an AVX2 CPU.
+// Tiers the CPU lacks stay off whatever the override says.
+static unsigned ss_probe_tiers(void)
+{
+    unsigned tiers = SS_TIER(SS_TIER_SCALAR) | SS_TIER(SS_TIER_BITSLICE);
+#if SS_LITTLE_ENDIAN && defined(__GNUC__)
+    tiers |= SS_TIER(SS_TIER_VEC);
+    // Two 64-bit lanes of SSE2 lose to scalar code, NEON and VSX rotate
+    // them natively. x86 runs them only when capped to vec, to test them.
+    if (!SS_X86_DISPATCH)
+    {
+        tiers |= SS_VEC64;
+    }
+#endif
+#if SS_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        tiers |= SS_TIER(SS_TIER_SSSE3);
+    }
+    if (__builtin_cpu_supports("pclmul"))
+    {
+        tiers |= SS_PCLMUL;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        tiers |= SS_TIER(SS_TIER_AVX2);
+    }
+    // The AVX-512 objects are built with -mavx512bw, and gcc uses BW mask
+    // moves (kmovd) even in the kernels that only need F
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+    {
+        tiers |= SS_TIER(SS_TIER_AVX512);
+    }
+#endif
+
+    // A name that is not a tier caps at scalar, so a typo never quietly
+    // runs the default kernels
+    const char *force = getenv("SIMONSPECK_TIER");
+    unsigned cap = force != NULL ? SS_TIER_SCALAR : SS_TIER_AVX512;
+    for (unsigned i = 0; force != NULL && i < SS_TIER_COUNT; i++)
+    {
+        cap = strcmp(force, ss_tier_names[i]) == 0 ? i : cap;
+    }
+    tiers &= (SS_TIER(cap + 1) - 1) | SS_PCLMUL | SS_VEC64;
+    tiers |= force != NULL && cap == SS_TIER_VEC ? SS_VEC64 : 0;
+    if (!(tiers & SS_TIER(SS_TIER_SSSE3)))
+    {
+        tiers &= ~SS_PCLMUL;
+    }
+    return tiers;
+}
+
+// Probed on the first context, every later one reuses the answer. Racing
+// first calls store the same value.
+static unsigned ss_tiers(void)
+{
+    static unsigned cached;
+    unsigned tiers = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+    if (tiers == 0)
+    {
+        tiers = ss_probe_tiers();
+        __atomic_store_n(&cached, tiers, __ATOMIC_RELAXED);
+    }
+    return tiers;
+}
+
+// The JIT emits AVX2: 1610 MB/s for speck128_128 against 1510 for the
+// AVX2 kernel, but 3470 for the AVX-512 one
+int ss_jit_allowed(void)
+{
+    unsigned tiers = ss_tiers();
+    return (tiers & SS_TIER(SS_TIER_AVX2)) && !(tiers & SS_TIER(SS_TIER_AVX512));
+}
+
+int ss_has_pclmul(void)
+{
+    return (ss_tiers() & SS_PCLMUL) != 0;
+}
+
+// Fastest kernel for a variant among the tiers this machine runs, picked
+// once per context so block calls go straight through ctx->kernel
+const struct ss_kernel *ss_kernel_for(const simonspeck_variant *variant)
+{
+    unsigned tiers = ss_tiers();
+
+#if SS_X86_DISPATCH
+    if (tiers & SS_TIER(SS_TIER_AVX512))
+    {
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 64)
+        {
+            return &ss_speck128_avx512;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 32)
+        {
+            return &ss_speck64_avx512;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 16)
+        {
+            return &ss_speck32_avx512;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 64)
+        {
+            return &ss_simon128_avx512;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 32)
+        {
+            return &ss_simon64_avx512;
+        }
+    }
+    if (tiers & SS_TIER(SS_TIER_AVX2))
+    {
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 64)
+        {
+            return &ss_speck128_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 32)
+        {
+            return &ss_speck64_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 16)
+        {
+            return &ss_speck32_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 64)
+        {
+            return &ss_simon128_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 32)
+        {
+            return &ss_simon64_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 16)
+        {
+            return &ss_simon32_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 48)
+        {
+            return &ss_speck96_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 24)
+        {
+            return &ss_speck48_avx2;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 48)
+        {
+            return &ss_simon96_avx2;
+        }
+    }
+    if (tiers & SS_TIER(SS_TIER_SSSE3))
+    {
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 32)
+        {
+            return &ss_speck64_ssse3;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 16)
+        {
+            return &ss_speck32_ssse3;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 32)
+        {
+            return &ss_simon64_ssse3;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 16)
+        {
+            return &ss_simon32_ssse3;
+        }
+    }
+#endif
+#if SS_LITTLE_ENDIAN && defined(__GNUC__)
+    if (tiers & SS_TIER(SS_TIER_VEC))
+    {
+        if ((tiers & SS_VEC64) && variant->cipher == SIMONSPECK_SPECK && variant->word_size == 64)
+        {
+            return &ss_speck128_vec;
+        }
+        if ((tiers & SS_VEC64) && variant->cipher == SIMONSPECK_SIMON && variant->word_size == 64)
+        {
+            return &ss_simon128_vec;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 32)
+        {
+            return &ss_speck64_vec;
+        }
+        if (variant->cipher == SIMONSPECK_SPECK && variant->word_size == 16)
+        {
+            return &ss_speck32_vec;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 32)
+        {
+            return &ss_simon64_vec;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 16)
+        {
+            return &ss_simon32_vec;
+        }
+    }
+#endif
+    if (tiers & SS_TIER(SS_TIER_BITSLICE))
+    {
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 16)
+        {
+            return &ss_simon32_bitslice;
+        }
+        if (variant->cipher == SIMONSPECK_SIMON && variant->word_size == 24)
+        {
+            return &ss_simon48_bitslice;
+        }
+    }
+    return NULL;
+}
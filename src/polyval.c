@@ -0,0 +1,102 @@
+/**
+* polyval.c - POLYVAL universal hash
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "gf128.h"
+
+// Portable multiply, bmul64 based and constant time
+SS_INLINE void ss_gf256_xor(ss_gf256 *d, ss_gf256 x)
+{
+    d->lo.lo ^= x.lo.lo;
+    d->lo.hi ^= x.lo.hi;
+    d->hi.lo ^= x.hi.lo;
+    d->hi.hi ^= x.hi.hi;
+}
+
+SS_INLINE ss_gf128 ss_polyval_load(const uint8_t *p, int reversed)
+{
+    return reversed ? ss_gf128_load_reversed(p) : ss_gf128_load(p);
+}
+
+SS_INLINE void ss_polyval_absorb(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks,
+                                 int reversed)
+{
+    ss_gf128 s = *acc;
+
+    // Four blocks per reduction: (s ^ x0) h^4 + x1 h^3 + x2 h^2 + x3 h
+    for (; nblocks >= 4; nblocks -= 4, in += 64)
+    {
+        ss_gf128 x = ss_polyval_load(in, reversed);
+        s.lo ^= x.lo;
+        s.hi ^= x.hi;
+        ss_gf256 d = ss_gf128_mul_wide(s, key->h[3]);
+        ss_gf256_xor(&d, ss_gf128_mul_wide(ss_polyval_load(in + 16, reversed), key->h[2]));
+        ss_gf256_xor(&d, ss_gf128_mul_wide(ss_polyval_load(in + 32, reversed), key->h[1]));
+        ss_gf256_xor(&d, ss_gf128_mul_wide(ss_polyval_load(in + 48, reversed), key->h[0]));
+        s = ss_polyval_reduce(d);
+    }
+
+    for (; nblocks > 0; nblocks--, in += 16)
+    {
+        ss_gf128 x = ss_polyval_load(in, reversed);
+        s.lo ^= x.lo;
+        s.hi ^= x.hi;
+        s = ss_polyval_dot(s, key->h[0]);
+    }
+    *acc = s;
+}
+
+static void ss_polyval_blocks_generic(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in,
+                                      size_t nblocks)
+{
+    ss_polyval_absorb(key, acc, in, nblocks, 0);
+}
+
+static void ss_ghash_blocks_generic(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in,
+                                    size_t nblocks)
+{
+    ss_polyval_absorb(key, acc, in, nblocks, 1);
+}
+
+void ss_polyval_init(ss_polyval_key *key, ss_gf128 h)
+{
+    key->h[0] = h;
+    for (int i = 1; i < 4; i++)
+    {
+        key->h[i] = ss_polyval_dot(key->h[i - 1], h);
+    }
+
+    key->polyval = ss_polyval_blocks_generic;
+    key->ghash = ss_ghash_blocks_generic;
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (ss_has_pclmul())
+    {
+        key->polyval = ss_polyval_blocks_pclmul;
+        key->ghash = ss_ghash_blocks_pclmul;
+    }
+#endif
+}
@@ -0,0 +1,109 @@
+/**
+* polyval_pclmul.c - POLYVAL and GHASH with PCLMULQDQ
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "gf128.h"
+
+// Built with -mpclmul -mssse3 on x86-64, ss_polyval_init picks it when
+// CPUID reports both
+#if defined(__PCLMUL__) && defined(__SSSE3__)
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+SS_INLINE __m128i ss_polyval_m128(ss_gf128 a)
+{
+    return _mm_set_epi64x((long long)a.hi, (long long)a.lo);
+}
+
+SS_INLINE void ss_polyval_mul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *mid, __m128i *hi)
+{
+    *lo = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x01));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x10));
+}
+
+// Same two Montgomery folds as ss_polyval_reduce
+SS_INLINE __m128i ss_polyval_reduce_m128(__m128i lo, __m128i mid, __m128i hi)
+{
+    const __m128i poly = _mm_set_epi64x((long long)0xc200000000000000, 0);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+    __m128i x = _mm_xor_si128(_mm_shuffle_epi32(lo, 0x4e), _mm_clmulepi64_si128(lo, poly, 0x10));
+    x = _mm_xor_si128(_mm_shuffle_epi32(x, 0x4e), _mm_clmulepi64_si128(x, poly, 0x10));
+    return _mm_xor_si128(hi, x);
+}
+
+// GHASH blocks enter byte reversed (RFC 8452 appendix A)
+SS_INLINE __m128i ss_polyval_load_m128(const uint8_t *p, int reversed)
+{
+    const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    return reversed ? _mm_shuffle_epi8(x, swap) : x;
+}
+
+SS_INLINE void ss_polyval_absorb(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks,
+                                 int reversed)
+{
+    const __m128i h1 = ss_polyval_m128(key->h[0]), h2 = ss_polyval_m128(key->h[1]);
+    const __m128i h3 = ss_polyval_m128(key->h[2]), h4 = ss_polyval_m128(key->h[3]);
+    __m128i s = ss_polyval_m128(*acc);
+
+    // Four blocks per reduction: (s ^ x0) h^4 + x1 h^3 + x2 h^2 + x3 h
+    for (; nblocks >= 4; nblocks -= 4, in += 64)
+    {
+        __m128i lo = _mm_setzero_si128(), mid = lo, hi = lo;
+        s = _mm_xor_si128(s, ss_polyval_load_m128(in, reversed));
+        ss_polyval_mul_acc(s, h4, &lo, &mid, &hi);
+        ss_polyval_mul_acc(ss_polyval_load_m128(in + 16, reversed), h3, &lo, &mid, &hi);
+        ss_polyval_mul_acc(ss_polyval_load_m128(in + 32, reversed), h2, &lo, &mid, &hi);
+        ss_polyval_mul_acc(ss_polyval_load_m128(in + 48, reversed), h1, &lo, &mid, &hi);
+        s = ss_polyval_reduce_m128(lo, mid, hi);
+    }
+
+    for (; nblocks > 0; nblocks--, in += 16)
+    {
+        __m128i lo = _mm_setzero_si128(), mid = lo, hi = lo;
+        s = _mm_xor_si128(s, ss_polyval_load_m128(in, reversed));
+        ss_polyval_mul_acc(s, h1, &lo, &mid, &hi);
+        s = ss_polyval_reduce_m128(lo, mid, hi);
+    }
+
+    acc->lo = (uint64_t)_mm_cvtsi128_si64(s);
+    acc->hi = (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(s, 8));
+}
+
+void ss_polyval_blocks_pclmul(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks)
+{
+    ss_polyval_absorb(key, acc, in, nblocks, 0);
+}
+
+void ss_ghash_blocks_pclmul(const ss_polyval_key *key, ss_gf128 *acc, const uint8_t *in, size_t nblocks)
+{
+    ss_polyval_absorb(key, acc, in, nblocks, 1);
+}
+#endif
@@ -0,0 +1,117 @@
+/**
+* simon.c - Simon implementation, all variants
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+const uint64_t ss_simon_z[5] = {
+    0b0001100111000011010100100010111110110011100001101010010001011111,
+    0b0001011010000110010011111011100010101101000011001001111101110001,
+    0b0011001101101001111110001000010100011001001011000000111011110101,
+    0b0011110000101100111001010001001000000111101001100011010111011011,
+    0b0011110111001001010011000011101000000100011011010110011110001011,
+};
+
+#define SS_VARIANT simon64_32
+#define SS_WORD uint16_t
+#define SS_WORD_BITS 16
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 32
+#define SS_Z 0
+#include "simon_impl.h"
+
+#define SS_VARIANT simon72_48
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 24
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 36
+#define SS_Z 0
+#include "simon_impl.h"
+
+#define SS_VARIANT simon96_48
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 24
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 36
+#define SS_Z 1
+#include "simon_impl.h"
+
+#define SS_VARIANT simon96_64
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 32
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 42
+#define SS_Z 2
+#include "simon_impl.h"
+
+#define SS_VARIANT simon128_64
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 32
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 44
+#define SS_Z 3
+#include "simon_impl.h"
+
+#define SS_VARIANT simon96_96
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 48
+#define SS_KEY_WORDS 2
+#define SS_ROUNDS 52
+#define SS_Z 2
+#include "simon_impl.h"
+
+#define SS_VARIANT simon144_96
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 48
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 54
+#define SS_Z 3
+#include "simon_impl.h"
+
+#define SS_VARIANT simon128_128
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 64
+#define SS_KEY_WORDS 2
+#define SS_ROUNDS 68
+#define SS_Z 2
+#include "simon_impl.h"
+
+#define SS_VARIANT simon192_128
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 64
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 69
+#define SS_Z 3
+#include "simon_impl.h"
+
+#define SS_VARIANT simon256_128
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 64
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 72
+#define SS_Z 4
+#include "simon_impl.h"
@@ -0,0 +1,183 @@
+/**
+* simon_avx2.c - AVX2 Simon kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__AVX2__)
+#include "avx2.h"
+
+// Simon128: 64-bit lanes, four blocks per register pair. S8 is a byte
+// shuffle, S1 and S2 shift/or.
+SS_INLINE __m256i ss_simon128_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi64x((long long)((const uint64_t *)schedule)[i]);
+}
+
+SS_INLINE __m256i ss_simon128_avx2_f(__m256i x)
+{
+    __m256i s1 = _mm256_or_si256(_mm256_slli_epi64(x, 1), _mm256_srli_epi64(x, 63));
+    __m256i s2 = _mm256_or_si256(_mm256_slli_epi64(x, 2), _mm256_srli_epi64(x, 62));
+    return _mm256_xor_si256(_mm256_and_si256(s1, ss_avx2_rol8_64(x)), s2);
+}
+
+SS_INLINE void ss_simon128_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = *x;
+    *x = _mm256_xor_si256(_mm256_xor_si256(*y, ss_simon128_avx2_f(*x)), k);
+    *y = t;
+}
+
+SS_INLINE void ss_simon128_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = *y;
+    *y = _mm256_xor_si256(_mm256_xor_si256(*x, ss_simon128_avx2_f(*y)), k);
+    *x = t;
+}
+
+#define SS_KERNEL ss_simon128_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 4
+#define SS_KERNEL_BLOCK 16
+#define SS_KERNEL_LOAD ss_avx2_load_64
+#define SS_KERNEL_STORE ss_avx2_store_64
+#include "kernel_impl.h"
+
+// Simon64: 32-bit lanes, eight blocks per register pair
+SS_INLINE __m256i ss_simon64_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi32((int)((const uint32_t *)schedule)[i]);
+}
+
+SS_INLINE __m256i ss_simon64_avx2_f(__m256i x)
+{
+    __m256i s1 = _mm256_or_si256(_mm256_slli_epi32(x, 1), _mm256_srli_epi32(x, 31));
+    __m256i s2 = _mm256_or_si256(_mm256_slli_epi32(x, 2), _mm256_srli_epi32(x, 30));
+    return _mm256_xor_si256(_mm256_and_si256(s1, ss_avx2_rol8_32(x)), s2);
+}
+
+SS_INLINE void ss_simon64_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = *x;
+    *x = _mm256_xor_si256(_mm256_xor_si256(*y, ss_simon64_avx2_f(*x)), k);
+    *y = t;
+}
+
+SS_INLINE void ss_simon64_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = *y;
+    *y = _mm256_xor_si256(_mm256_xor_si256(*x, ss_simon64_avx2_f(*y)), k);
+    *x = t;
+}
+
+#define SS_KERNEL ss_simon64_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 8
+#define SS_KERNEL_BLOCK 8
+#define SS_KERNEL_LOAD ss_avx2_load_32
+#define SS_KERNEL_STORE ss_avx2_store_32
+#include "kernel_impl.h"
+
+// Simon32: 16-bit lanes, sixteen blocks per register pair. S8 swaps the
+// bytes of each lane.
+SS_INLINE __m256i ss_simon32_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi16((short)((const uint16_t *)schedule)[i]);
+}
+
+SS_INLINE __m256i ss_simon32_avx2_f(__m256i x)
+{
+    __m256i s1 = _mm256_or_si256(_mm256_slli_epi16(x, 1), _mm256_srli_epi16(x, 15));
+    __m256i s2 = _mm256_or_si256(_mm256_slli_epi16(x, 2), _mm256_srli_epi16(x, 14));
+    return _mm256_xor_si256(_mm256_and_si256(s1, ss_avx2_rot8_16(x)), s2);
+}
+
+SS_INLINE void ss_simon32_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = *x;
+    *x = _mm256_xor_si256(_mm256_xor_si256(*y, ss_simon32_avx2_f(*x)), k);
+    *y = t;
+}
+
+SS_INLINE void ss_simon32_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = *y;
+    *y = _mm256_xor_si256(_mm256_xor_si256(*x, ss_simon32_avx2_f(*y)), k);
+    *x = t;
+}
+
+#define SS_KERNEL ss_simon32_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 16
+#define SS_KERNEL_BLOCK 4
+#define SS_KERNEL_LOAD ss_avx2_load_16
+#define SS_KERNEL_STORE ss_avx2_store_16
+#include "kernel_impl.h"
+
+// Simon96: 48-bit words in 64-bit lanes, four 12-byte blocks per register
+// pair. S8 is a byte shuffle that leaves the bits above the word clear, S1
+// and S2 carry into them, so each new word is masked once.
+SS_INLINE __m256i ss_simon96_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi64x((long long)((const uint64_t *)schedule)[i]);
+}
+
+SS_INLINE __m256i ss_simon96_avx2_f(__m256i x)
+{
+    __m256i s1 = _mm256_or_si256(_mm256_slli_epi64(x, 1), _mm256_srli_epi64(x, 47));
+    __m256i s2 = _mm256_or_si256(_mm256_slli_epi64(x, 2), _mm256_srli_epi64(x, 46));
+    return _mm256_xor_si256(_mm256_and_si256(s1, ss_avx2_rol8_48(x)), s2);
+}
+
+SS_INLINE void ss_simon96_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xffffffffffff);
+    __m256i t = *x;
+    *x = _mm256_and_si256(_mm256_xor_si256(_mm256_xor_si256(*y, ss_simon96_avx2_f(*x)), k), mask);
+    *y = t;
+}
+
+SS_INLINE void ss_simon96_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xffffffffffff);
+    __m256i t = *y;
+    *y = _mm256_and_si256(_mm256_xor_si256(_mm256_xor_si256(*x, ss_simon96_avx2_f(*y)), k), mask);
+    *x = t;
+}
+
+#define SS_KERNEL ss_simon96_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 4
+#define SS_KERNEL_BLOCK 12
+#define SS_KERNEL_LOAD ss_avx2_load_48
+#define SS_KERNEL_STORE ss_avx2_store_48
+#include "kernel_impl.h"
+#endif
@@ -0,0 +1,113 @@
+/**
+* simon_avx512.c - AVX-512 Simon kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__AVX512F__)
+#include "avx512.h"
+
+// The round x' = y ^ (S1 x & S8 x) ^ S2 x ^ k is three lane rotates and
+// two VPTERNLOGs: 0x6a is (a & b) ^ c, 0x96 is a ^ b ^ c. Tails go through
+// one masked register pair.
+
+// Simon128: 64-bit lanes, eight blocks per register pair
+SS_INLINE __m512i ss_simon128_avx512_key(const void *schedule, unsigned i)
+{
+    return _mm512_set1_epi64((long long)((const uint64_t *)schedule)[i]);
+}
+
+SS_INLINE __m512i ss_simon128_avx512_g(__m512i x, __m512i y, __m512i k)
+{
+    __m512i f = _mm512_ternarylogic_epi64(_mm512_rol_epi64(x, 1), _mm512_rol_epi64(x, 8),
+                                          _mm512_rol_epi64(x, 2), 0x6a);
+    return _mm512_ternarylogic_epi64(f, y, k, 0x96);
+}
+
+SS_INLINE void ss_simon128_avx512_round(__m512i *x, __m512i *y, __m512i k)
+{
+    __m512i t = *x;
+    *x = ss_simon128_avx512_g(*x, *y, k);
+    *y = t;
+}
+
+SS_INLINE void ss_simon128_avx512_inverse_round(__m512i *x, __m512i *y, __m512i k)
+{
+    __m512i t = *y;
+    *y = ss_simon128_avx512_g(*y, *x, k);
+    *x = t;
+}
+
+#define SS_KERNEL ss_simon128_avx512
+#define SS_KERNEL_TIER "avx512"
+#define SS_KERNEL_VEC __m512i
+#define SS_KERNEL_LANES 8
+#define SS_KERNEL_BLOCK 16
+#define SS_KERNEL_LOAD ss_avx512_load_64
+#define SS_KERNEL_STORE ss_avx512_store_64
+#define SS_KERNEL_LOAD_PARTIAL ss_avx512_load_partial_64
+#define SS_KERNEL_STORE_PARTIAL ss_avx512_store_partial_64
+#include "kernel_impl.h"
+
+// Simon64: 32-bit lanes, sixteen blocks per register pair
+SS_INLINE __m512i ss_simon64_avx512_key(const void *schedule, unsigned i)
+{
+    return _mm512_set1_epi32((int)((const uint32_t *)schedule)[i]);
+}
+
+SS_INLINE __m512i ss_simon64_avx512_g(__m512i x, __m512i y, __m512i k)
+{
+    __m512i f = _mm512_ternarylogic_epi32(_mm512_rol_epi32(x, 1), _mm512_rol_epi32(x, 8),
+                                          _mm512_rol_epi32(x, 2), 0x6a);
+    return _mm512_ternarylogic_epi32(f, y, k, 0x96);
+}
+
+SS_INLINE void ss_simon64_avx512_round(__m512i *x, __m512i *y, __m512i k)
+{
+    __m512i t = *x;
+    *x = ss_simon64_avx512_g(*x, *y, k);
+    *y = t;
+}
+
+SS_INLINE void ss_simon64_avx512_inverse_round(__m512i *x, __m512i *y, __m512i k)
+{
+    __m512i t = *y;
+    *y = ss_simon64_avx512_g(*y, *x, k);
+    *x = t;
+}
+
+#define SS_KERNEL ss_simon64_avx512
+#define SS_KERNEL_TIER "avx512"
+#define SS_KERNEL_VEC __m512i
+#define SS_KERNEL_LANES 16
+#define SS_KERNEL_BLOCK 8
+#define SS_KERNEL_LOAD ss_avx512_load_32
+#define SS_KERNEL_STORE ss_avx512_store_32
+#define SS_KERNEL_LOAD_PARTIAL ss_avx512_load_partial_32
+#define SS_KERNEL_STORE_PARTIAL ss_avx512_store_partial_32
+#include "kernel_impl.h"
+#endif
@@ -0,0 +1,199 @@
+/**
+* simon_bitslice.c - Bitsliced Simon for the 16 and 24-bit word variants
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+// Bit i of every word of SS_BITSLICE_BLOCKS blocks is held in one slice,
+// block b in lane b / 64, bit b % 64. The rotations of f then only pick
+// other slices and each and/xor works on all blocks at once. A round key
+// bit becomes an all-ones or zero mask. Slices are generic vectors, which
+// gcc and clang split into whatever registers the target has.
+#define SS_BITSLICE_WORDS 4
+#define SS_BITSLICE_BLOCKS (64 * SS_BITSLICE_WORDS)
+
+// A pass costs roughly as much as this many blocks of scalar code, shorter
+// tails are left to it
+#define SS_BITSLICE_MIN 64
+
+typedef uint64_t ss_slice __attribute__((vector_size(8 * SS_BITSLICE_WORDS)));
+
+// In place transpose of the 64 x 64 bit matrix in lane w of every a[r],
+// row r bit c <-> row c bit r, all lanes at once
+static void ss_bitslice_transpose(ss_slice a[64])
+{
+    static const uint64_t masks[6] = {
+        0x00000000ffffffff, 0x0000ffff0000ffff, 0x00ff00ff00ff00ff,
+        0x0f0f0f0f0f0f0f0f, 0x3333333333333333, 0x5555555555555555,
+    };
+
+#pragma GCC unroll 6
+    for (unsigned s = 0; s < 6; s++)
+    {
+        const unsigned j = 32 >> s;
+#pragma GCC unroll 32
+        for (unsigned r = 0; r < 64; r = ((r | j) + 1) & ~j)
+        {
+            ss_slice t = ((a[r] >> j) ^ a[r + j]) & masks[s];
+            a[r] ^= t << j;
+            a[r + j] ^= t;
+        }
+    }
+}
+
+// Block b of n. A 48-bit block that is not the last one moves with a single
+// 8-byte access that overlaps the next block, which a store in block order
+// overwrites again.
+SS_INLINE uint64_t ss_bitslice_load_block(const uint8_t *in, size_t b, size_t n, unsigned block)
+{
+    if (SS_LITTLE_ENDIAN && block == 6 && b + 1 < n)
+    {
+        uint64_t v;
+        memcpy(&v, in + b * block, 8);
+        return v & 0xffffffffffff;
+    }
+    return b < n ? ss_load_le(in + b * block, block) : 0;
+}
+
+SS_INLINE void ss_bitslice_store_block(uint8_t *out, size_t b, size_t n, unsigned block, uint64_t v)
+{
+    if (SS_LITTLE_ENDIAN && block == 6 && b + 1 < n)
+    {
+        memcpy(out + b * block, &v, 8);
+        return;
+    }
+    ss_store_le(out + b * block, v, block);
+}
+
+// n blocks of 2 * bits bits in -> slices, y in s[0..bits), x in
+// s[bits..2 * bits). Blocks past n are zero.
+SS_INLINE void ss_bitslice_load(ss_slice s[64], const uint8_t *in, size_t n, unsigned bits)
+{
+    for (size_t b = 0; b < SS_BITSLICE_BLOCKS; b++)
+    {
+        s[b % 64][b / 64] = ss_bitslice_load_block(in, b, n, bits / 4);
+    }
+    ss_bitslice_transpose(s);
+}
+
+// Slices -> n blocks, the slices past 2 * bits are cleared first so the
+// bits above each block are zero
+SS_INLINE void ss_bitslice_store(uint8_t *out, ss_slice s[64], size_t n, unsigned bits)
+{
+    for (unsigned i = 2 * bits; i < 64; i++)
+    {
+        s[i] = (ss_slice){0};
+    }
+    ss_bitslice_transpose(s);
+    for (size_t b = 0; b < n; b++)
+    {
+        ss_bitslice_store_block(out, b, n, bits / 4, s[b % 64][b / 64]);
+    }
+}
+
+// b ^= f(a) ^ k, one Feistel round without the swap. S^j a is slice
+// (i - j) mod bits, constant once the loop is unrolled.
+SS_INLINE void ss_bitslice_round(ss_slice *restrict b, const ss_slice *restrict a, uint64_t k, unsigned bits)
+{
+#pragma GCC unroll 24
+    for (unsigned i = 0; i < bits; i++)
+    {
+        b[i] ^= (a[(i + bits - 1) % bits] & a[(i + bits - 8) % bits]) ^ a[(i + bits - 2) % bits] ^
+                (0 - ((k >> i) & 1));
+    }
+}
+
+// Each round updates one half from the other in place and the halves then
+// trade roles, so neither is ever copied. Simon32 has 32 rounds and Simon48
+// 36, so after an even count the halves are back where they started.
+// Decryption is encryption with the halves and the round key order swapped.
+SS_INLINE size_t ss_bitslice_crypt(const void *schedule, unsigned rounds, const uint8_t *in,
+                                   uint8_t *out, size_t nblocks, unsigned bits, int decrypt)
+{
+    const unsigned block = bits / 4;
+    ss_slice s[64];
+    size_t done = 0;
+
+    while (nblocks - done >= SS_BITSLICE_MIN)
+    {
+        size_t n = nblocks - done < SS_BITSLICE_BLOCKS ? nblocks - done : SS_BITSLICE_BLOCKS;
+        ss_slice *src = decrypt ? s : s + bits;
+        ss_slice *dst = decrypt ? s + bits : s;
+
+        ss_bitslice_load(s, in + done * block, n, bits);
+        for (unsigned i = 0; i < rounds; i++)
+        {
+            unsigned r = decrypt ? rounds - 1 - i : i;
+            uint64_t k = bits == 16 ? ((const uint16_t *)schedule)[r] : ((const uint32_t *)schedule)[r];
+            ss_slice *t = src;
+            ss_bitslice_round(dst, src, k, bits);
+            src = dst;
+            dst = t;
+        }
+        ss_bitslice_store(out + done * block, s, n, bits);
+        done += n;
+    }
+    return done;
+}
+
+// Simon32: simon64_32
+static size_t ss_simon32_bitslice_encrypt(const void *schedule, unsigned rounds,
+                                          const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    return ss_bitslice_crypt(schedule, rounds, in, out, nblocks, 16, 0);
+}
+
+static size_t ss_simon32_bitslice_decrypt(const void *schedule, unsigned rounds,
+                                          const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    return ss_bitslice_crypt(schedule, rounds, in, out, nblocks, 16, 1);
+}
+
+const struct ss_kernel ss_simon32_bitslice = {
+    .name = "bitslice",
+    .encrypt_blocks = ss_simon32_bitslice_encrypt,
+    .decrypt_blocks = ss_simon32_bitslice_decrypt,
+};
+
+// Simon48: simon72_48 and simon96_48
+static size_t ss_simon48_bitslice_encrypt(const void *schedule, unsigned rounds,
+                                          const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    return ss_bitslice_crypt(schedule, rounds, in, out, nblocks, 24, 0);
+}
+
+static size_t ss_simon48_bitslice_decrypt(const void *schedule, unsigned rounds,
+                                          const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    return ss_bitslice_crypt(schedule, rounds, in, out, nblocks, 24, 1);
+}
+
+const struct ss_kernel ss_simon48_bitslice = {
+    .name = "bitslice",
+    .encrypt_blocks = ss_simon48_bitslice_encrypt,
+    .decrypt_blocks = ss_simon48_bitslice_decrypt,
+};
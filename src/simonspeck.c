@@ -0,0 +1,247 @@
+/**
+* simonspeck.c - Variant registry and context management
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+#define SIMON(id, key, block, m, T) \
+    [id] = { id, "simon" #key "_" #block, SIMONSPECK_SIMON, key, block, block / 2, m, block / 16, T }
+#define SPECK(id, key, block, m, T) \
+    [id] = { id, "speck" #key "_" #block, SIMONSPECK_SPECK, key, block, block / 2, m, block / 16, T }
+
+const simonspeck_variant simonspeck_variants[SIMONSPECK_VARIANT_COUNT] = {
+    SIMON(SIMON_64_32, 64, 32, 4, 32),
+    SIMON(SIMON_72_48, 72, 48, 3, 36),
+    SIMON(SIMON_96_64, 96, 64, 3, 42),
+    SIMON(SIMON_128_64, 128, 64, 4, 44),
+    SIMON(SIMON_96_96, 96, 96, 2, 52),
+    SIMON(SIMON_144_96, 144, 96, 3, 54),
+    SIMON(SIMON_128_128, 128, 128, 2, 68),
+    SIMON(SIMON_192_128, 192, 128, 3, 69),
+    SIMON(SIMON_256_128, 256, 128, 4, 72),
+    SPECK(SPECK_64_32, 64, 32, 4, 22),
+    SPECK(SPECK_72_48, 72, 48, 3, 22),
+    SPECK(SPECK_96_48, 96, 48, 4, 23),
+    SPECK(SPECK_96_64, 96, 64, 3, 26),
+    SPECK(SPECK_128_64, 128, 64, 4, 27),
+    SPECK(SPECK_96_96, 96, 96, 2, 28),
+    SPECK(SPECK_144_96, 144, 96, 3, 29),
+    SPECK(SPECK_128_128, 128, 128, 2, 32),
+    SPECK(SPECK_192_128, 192, 128, 3, 33),
+    SPECK(SPECK_256_128, 256, 128, 4, 34),
+    SIMON(SIMON_96_48, 96, 48, 4, 36),
+};
+
+#undef SIMON
+#undef SPECK
+
+#define SS_OPS_ENTRY(id, name) [id] = &ss_##name##_ops,
+static const struct ss_ops *const ss_ops_table[SIMONSPECK_VARIANT_COUNT] = {
+    SS_FOR_EACH_VARIANT(SS_OPS_ENTRY)
+};
+#undef SS_OPS_ENTRY
+
+const simonspeck_variant *simonspeck_find_variant(const char *name)
+{
+    for (int i = 0; i < SIMONSPECK_VARIANT_COUNT; i++)
+    {
+        if (strcmp(simonspeck_variants[i].name, name) == 0)
+        {
+            return &simonspeck_variants[i];
+        }
+    }
+    return NULL;
+}
+
+simonspeck_ctx *simonspeck_new(simonspeck_variant_id id, const uint8_t *key)
+{
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT)
+    {
+        return NULL;
+    }
+
+    const struct ss_ops *ops = ss_ops_table[id];
+    // aligned_alloc wants a multiple of the alignment
+    size_t size = sizeof(simonspeck_ctx) + ops->schedule_bytes;
+    size = (size + SS_CACHE_LINE - 1) & ~(size_t)(SS_CACHE_LINE - 1);
+
+    simonspeck_ctx *ctx = aligned_alloc(SS_CACHE_LINE, size);
+    if (ctx == NULL)
+    {
+        return NULL;
+    }
+
+    ctx->variant = &simonspeck_variants[id];
+    ctx->ops = ops;
+    ctx->kernel = ss_kernel_for(ctx->variant);
+    ctx->jit = NULL;
+    ctx->size = size;
+    ops->expand(ctx->schedule, key);
+    return ctx;
+}
+
+void simonspeck_set_key(simonspeck_ctx *ctx, const uint8_t *key)
+{
+    ctx->ops->expand(ctx->schedule, key);
+    if (ctx->jit != NULL)
+    {
+        ss_jit_compile(ctx);
+    }
+}
+
+int simonspeck_set_keys(simonspeck_ctx *const *ctxs, const uint8_t *const *keys, size_t n)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        if (ctxs[i]->ops != ctxs[0]->ops)
+        {
+            return SIMONSPECK_EINVAL;
+        }
+    }
+
+    while (n > 0)
+    {
+        void *schedules[SS_KEY_LANES];
+        unsigned lanes = n < SS_KEY_LANES ? (unsigned)n : SS_KEY_LANES;
+        for (unsigned j = 0; j < lanes; j++)
+        {
+            schedules[j] = ctxs[j]->schedule;
+        }
+        ctxs[0]->ops->expand_lanes(schedules, keys, lanes);
+        for (unsigned j = 0; j < lanes; j++)
+        {
+            if (ctxs[j]->jit != NULL)
+            {
+                ss_jit_compile(ctxs[j]);
+            }
+        }
+        ctxs += lanes, keys += lanes, n -= lanes;
+    }
+    return SIMONSPECK_OK;
+}
+
+void simonspeck_free(simonspeck_ctx *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    ss_jit_release(ctx);
+
+    // volatile so the wipe is not dropped as a dead store before free()
+    volatile uint8_t *p = (volatile uint8_t *)ctx;
+    size_t size = ctx->size;
+    for (size_t i = 0; i < size; i++)
+    {
+        p[i] = 0;
+    }
+    free(ctx);
+}
+
+int simonspeck_jit(simonspeck_ctx *ctx)
+{
+    return ss_jit_compile(ctx);
+}
+
+const simonspeck_variant *simonspeck_ctx_variant(const simonspeck_ctx *ctx)
+{
+    return ctx->variant;
+}
+
+const char *simonspeck_ctx_tier(const simonspeck_ctx *ctx)
+{
+    return ctx->kernel != NULL ? ctx->kernel->name : "scalar";
+}
+
+void simonspeck_encrypt(const simonspeck_ctx *ctx, const uint8_t *in, uint8_t *out)
+{
+    ctx->ops->encrypt(ctx->schedule, in, out);
+}
+
+void simonspeck_decrypt(const simonspeck_ctx *ctx, const uint8_t *in, uint8_t *out)
+{
+    ctx->ops->decrypt(ctx->schedule, in, out);
+}
+
+int simonspeck_encrypt_once(simonspeck_variant_id id, const uint8_t *key,
+                            const uint8_t *in, uint8_t *out)
+{
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_ops_table[id]->encrypt_once(key, in, out);
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_decrypt_once(simonspeck_variant_id id, const uint8_t *key,
+                            const uint8_t *in, uint8_t *out)
+{
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_ops_table[id]->decrypt_once(key, in, out);
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_reverse_key(simonspeck_variant_id id, const uint8_t *key, uint8_t *rkey)
+{
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_ops_table[id]->reverse_key(rkey, key);
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_decrypt_reverse(simonspeck_variant_id id, const uint8_t *rkey,
+                               const uint8_t *in, uint8_t *out)
+{
+    if ((unsigned)id >= SIMONSPECK_VARIANT_COUNT)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    ss_ops_table[id]->decrypt_reverse(rkey, in, out);
+    return SIMONSPECK_OK;
+}
+
+void simonspeck_encrypt_blocks(const simonspeck_ctx *ctx, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    ss_encrypt_blocks(ctx, in, out, nblocks);
+}
+
+void simonspeck_decrypt_blocks(const simonspeck_ctx *ctx, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    ss_decrypt_blocks(ctx, in, out, nblocks);
+}
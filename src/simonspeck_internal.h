@@ -0,0 +1,330 @@
+/**
+* simonspeck_internal.h - Simon and Speck library internals
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_INTERNAL_H
+#define SIMONSPECK_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "simonspeck.h"
+
+#define SS_CACHE_LINE 64
+#define SS_ALIGNED(n) __attribute__((aligned(n)))
+#define SS_INLINE static inline __attribute__((always_inline))
+
+// Keys per batched key expansion
+#define SS_KEY_LANES 8
+
+// Keystream and scratch buffers of the modes are this many bytes
+#define SS_BATCH_BYTES 1024
+
+#define SS_CAT_(a, b) a##b
+#define SS_CAT(a, b) SS_CAT_(a, b)
+
+typedef void (*ss_expand_fn)(void *schedule, const uint8_t *key);
+typedef void (*ss_expand_lanes_fn)(void *const *schedules, const uint8_t *const *keys, unsigned n);
+typedef void (*ss_block_fn)(const void *schedule, const uint8_t *in, uint8_t *out);
+typedef void (*ss_once_fn)(const uint8_t *key, const uint8_t *in, uint8_t *out);
+typedef void (*ss_blocks_fn)(const void *schedule, const uint8_t *in, uint8_t *out, size_t nblocks);
+
+struct ss_ops {
+    ss_expand_fn expand;
+    ss_expand_lanes_fn expand_lanes; // n <= SS_KEY_LANES keys at once
+    ss_block_fn encrypt;
+    ss_block_fn decrypt;
+    ss_once_fn encrypt_once; // key schedule fused into the rounds
+    ss_once_fn decrypt_once;
+    ss_expand_fn reverse_key; // key -> end state of the schedule
+    ss_once_fn decrypt_reverse; // schedule run backwards from that state
+    ss_blocks_fn encrypt_blocks;
+    ss_blocks_fn decrypt_blocks;
+    size_t schedule_bytes; // rounds * sizeof(word)
+};
+
+// SIMD kernel for one cipher and word size, shared by the variants that
+// differ only in key size. It handles a prefix of the nblocks it is given
+// and returns its length, the scalar blocks function does the rest.
+typedef size_t (*ss_kernel_fn)(const void *schedule, unsigned rounds,
+                               const uint8_t *in, uint8_t *out, size_t nblocks);
+
+struct ss_kernel {
+    const char *name;
+    ss_kernel_fn encrypt_blocks;
+    ss_kernel_fn decrypt_blocks;
+};
+
+struct simonspeck_ctx {
+    const simonspeck_variant *variant;
+    const struct ss_ops *ops;
+    const struct ss_kernel *kernel; // NULL when scalar only
+    struct ss_kernel jit_kernel; // kernel while jit is set
+    void *jit; // jit.c mapping, NULL when not compiled
+    size_t jit_size;
+    size_t size; // allocation size, for wiping
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t schedule[];
+};
+
+// X(id, name) for every variant, in simonspeck_variant_id order
+#define SS_FOR_EACH_VARIANT(X) \
+    X(SIMON_64_32, simon64_32) \
+    X(SIMON_72_48, simon72_48) \
+    X(SIMON_96_64, simon96_64) \
+    X(SIMON_128_64, simon128_64) \
+    X(SIMON_96_96, simon96_96) \
+    X(SIMON_144_96, simon144_96) \
+    X(SIMON_128_128, simon128_128) \
+    X(SIMON_192_128, simon192_128) \
+    X(SIMON_256_128, simon256_128) \
+    X(SPECK_64_32, speck64_32) \
+    X(SPECK_72_48, speck72_48) \
+    X(SPECK_96_48, speck96_48) \
+    X(SPECK_96_64, speck96_64) \
+    X(SPECK_128_64, speck128_64) \
+    X(SPECK_96_96, speck96_96) \
+    X(SPECK_144_96, speck144_96) \
+    X(SPECK_128_128, speck128_128) \
+    X(SPECK_192_128, speck192_128) \
+    X(SPECK_256_128, speck256_128) \
+    X(SIMON_96_48, simon96_48)
+
+#define SS_DECLARE_OPS(id, name) extern const struct ss_ops ss_##name##_ops;
+SS_FOR_EACH_VARIANT(SS_DECLARE_OPS)
+#undef SS_DECLARE_OPS
+
+// Simon round constant sequences z0..z4, bit i = (z >> i) & 1
+extern const uint64_t ss_simon_z[5];
+
+// kernels.c: fastest kernel this CPU runs for a variant, NULL if none
+const struct ss_kernel *ss_kernel_for(const simonspeck_variant *variant);
+
+// kernels.c: AVX2 is the best tier usable, CPU and SIMONSPECK_TIER allowing
+int ss_jit_allowed(void);
+
+// kernels.c: PCLMULQDQ for POLYVAL, needs the SSSE3 tier too
+int ss_has_pclmul(void);
+
+// jit.c: compile the context's key into an encryption kernel, or drop it
+int ss_jit_compile(simonspeck_ctx *ctx);
+void ss_jit_release(simonspeck_ctx *ctx);
+
+// Portable, any target
+extern const struct ss_kernel ss_simon32_bitslice;
+extern const struct ss_kernel ss_simon48_bitslice;
+
+// gcc/clang generic vectors, little endian targets
+extern const struct ss_kernel ss_speck128_vec;
+extern const struct ss_kernel ss_speck64_vec;
+extern const struct ss_kernel ss_speck32_vec;
+extern const struct ss_kernel ss_simon128_vec;
+extern const struct ss_kernel ss_simon64_vec;
+extern const struct ss_kernel ss_simon32_vec;
+
+// x86-64, built with their -m flags and picked by CPUID
+extern const struct ss_kernel ss_speck64_ssse3;
+extern const struct ss_kernel ss_speck32_ssse3;
+extern const struct ss_kernel ss_simon64_ssse3;
+extern const struct ss_kernel ss_simon32_ssse3;
+extern const struct ss_kernel ss_speck128_avx2;
+extern const struct ss_kernel ss_speck64_avx2;
+extern const struct ss_kernel ss_speck32_avx2;
+extern const struct ss_kernel ss_speck96_avx2;
+extern const struct ss_kernel ss_speck48_avx2;
+extern const struct ss_kernel ss_simon128_avx2;
+extern const struct ss_kernel ss_simon64_avx2;
+extern const struct ss_kernel ss_simon32_avx2;
+extern const struct ss_kernel ss_simon96_avx2;
+extern const struct ss_kernel ss_speck128_avx512;
+extern const struct ss_kernel ss_speck64_avx512;
+extern const struct ss_kernel ss_speck32_avx512;
+extern const struct ss_kernel ss_simon128_avx512;
+extern const struct ss_kernel ss_simon64_avx512;
+
+// Little endian hosts load and store whole 2, 4 and 8-byte words with a
+// single move, and 3 and 6-byte words with two, gcc does not merge the
+// byte loop at -O2
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SS_LITTLE_ENDIAN 1
+#else
+#define SS_LITTLE_ENDIAN 0
+#endif
+
+SS_INLINE uint64_t ss_load_le(const uint8_t *p, unsigned bytes)
+{
+    if (SS_LITTLE_ENDIAN && bytes >= 2 && bytes <= 8 && bytes != 5 && bytes != 7)
+    {
+        uint64_t v64;
+        uint32_t v32;
+        uint16_t v16;
+        switch (bytes)
+        {
+        case 2:
+            memcpy(&v16, p, 2);
+            return v16;
+        case 3:
+            memcpy(&v16, p, 2);
+            return v16 | (uint64_t)p[2] << 16;
+        case 4:
+            memcpy(&v32, p, 4);
+            return v32;
+        case 6:
+            memcpy(&v32, p, 4);
+            memcpy(&v16, p + 4, 2);
+            return v32 | (uint64_t)v16 << 32;
+        default:
+            memcpy(&v64, p, 8);
+            return v64;
+        }
+    }
+
+    uint64_t v = 0;
+    for (unsigned i = 0; i < bytes; i++)
+    {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+SS_INLINE void ss_store_le(uint8_t *p, uint64_t v, unsigned bytes)
+{
+    if (SS_LITTLE_ENDIAN && bytes >= 2 && bytes <= 8 && bytes != 5 && bytes != 7)
+    {
+        uint64_t v64 = v;
+        uint32_t v32 = (uint32_t)v;
+        uint16_t v16 = (uint16_t)v;
+        uint16_t h16 = (uint16_t)(v >> 32);
+        switch (bytes)
+        {
+        case 2:
+            memcpy(p, &v16, 2);
+            return;
+        case 3:
+            memcpy(p, &v16, 2);
+            p[2] = (uint8_t)(v >> 16);
+            return;
+        case 4:
+            memcpy(p, &v32, 4);
+            return;
+        case 6:
+            memcpy(p, &v32, 4);
+            memcpy(p + 4, &h16, 2);
+            return;
+        default:
+            memcpy(p, &v64, 8);
+            return;
+        }
+    }
+
+    for (unsigned i = 0; i < bytes; i++)
+    {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+SS_INLINE size_t ss_block_bytes(const simonspeck_ctx *ctx)
+{
+    return ctx->variant->block_size / 8;
+}
+
+SS_INLINE void ss_encrypt_blocks(const simonspeck_ctx *ctx, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    size_t done = 0;
+    if (ctx->kernel != NULL)
+    {
+        done = ctx->kernel->encrypt_blocks(ctx->schedule, ctx->variant->rounds, in, out, nblocks);
+    }
+    if (done < nblocks)
+    {
+        size_t offset = done * ss_block_bytes(ctx);
+        ctx->ops->encrypt_blocks(ctx->schedule, in + offset, out + offset, nblocks - done);
+    }
+}
+
+SS_INLINE void ss_decrypt_blocks(const simonspeck_ctx *ctx, const uint8_t *in, uint8_t *out, size_t nblocks)
+{
+    size_t done = 0;
+    if (ctx->kernel != NULL)
+    {
+        done = ctx->kernel->decrypt_blocks(ctx->schedule, ctx->variant->rounds, in, out, nblocks);
+    }
+    if (done < nblocks)
+    {
+        size_t offset = done * ss_block_bytes(ctx);
+        ctx->ops->decrypt_blocks(ctx->schedule, in + offset, out + offset, nblocks - done);
+    }
+}
+
+// out = a ^ b, any alignment, out may alias a or b
+SS_INLINE void ss_xor(uint8_t *out, const uint8_t *a, const uint8_t *b, size_t len)
+{
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        x ^= y;
+        memcpy(out + i, &x, 8);
+    }
+    for (; i < len; i++)
+    {
+        out[i] = a[i] ^ b[i];
+    }
+}
+
+// ctr.c: xor len bytes of keystream from counter block ctr into in -> out
+// and advance ctr past every block used, including a final partial one.
+// ctr is a 16-byte buffer whatever the block size.
+void ss_ctr_xor(const simonspeck_ctx *ctx, uint8_t *ctr, unsigned counter_bytes,
+                const uint8_t *in, uint8_t *out, size_t len);
+
+// Big endian increment of the last counter_bytes bytes of ctr, by n
+void ss_ctr_add(uint8_t *ctr, size_t block_bytes, unsigned counter_bytes, uint64_t n);
+
+// Counter blocks left before ctr wraps, saturating at UINT64_MAX
+uint64_t ss_ctr_blocks_left(const uint8_t *ctr, size_t block_bytes, unsigned counter_bytes);
+
+// CTR position kept between chunks, the unused tail of the last keystream
+// block stays in ks
+struct simonspeck_ctr_stream {
+    const simonspeck_ctx *ctx;
+    unsigned counter_bytes;
+    size_t used; // bytes of ks consumed, the block size when none are left
+    uint64_t blocks_left; // counter blocks that may still be generated
+    uint8_t ctr[16]; // next counter block
+    uint8_t ks[16];
+};
+
+// Start at counter block ctr, refusing to go past blocks_left blocks
+void ss_ctr_stream_start(struct simonspeck_ctr_stream *s, const simonspeck_ctx *ctx, const uint8_t *ctr,
+                         unsigned counter_bytes, uint64_t blocks_left);
+
+// cbc.c: nblocks of CBC with iv updated to the last ciphertext block
+void ss_cbc_encrypt(const simonspeck_ctx *ctx, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t nblocks);
+void ss_cbc_decrypt(const simonspeck_ctx *ctx, uint8_t *iv, const uint8_t *in, uint8_t *out, size_t nblocks);
+
+#endif
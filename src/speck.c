@@ -0,0 +1,119 @@
+/**
+* speck.c - Speck implementation, all variants
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+#define SS_VARIANT speck64_32
+#define SS_WORD uint16_t
+#define SS_WORD_BITS 16
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 22
+#define SS_ALPHA 7
+#define SS_BETA 2
+#include "speck_impl.h"
+
+#define SS_VARIANT speck72_48
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 24
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 22
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck96_48
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 24
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 23
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck96_64
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 32
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 26
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck128_64
+#define SS_WORD uint32_t
+#define SS_WORD_BITS 32
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 27
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck96_96
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 48
+#define SS_KEY_WORDS 2
+#define SS_ROUNDS 28
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck144_96
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 48
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 29
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck128_128
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 64
+#define SS_KEY_WORDS 2
+#define SS_ROUNDS 32
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck192_128
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 64
+#define SS_KEY_WORDS 3
+#define SS_ROUNDS 33
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
+
+#define SS_VARIANT speck256_128
+#define SS_WORD uint64_t
+#define SS_WORD_BITS 64
+#define SS_KEY_WORDS 4
+#define SS_ROUNDS 34
+#define SS_ALPHA 8
+#define SS_BETA 3
+#include "speck_impl.h"
@@ -0,0 +1,186 @@
+/**
+* speck_avx2.c - AVX2 Speck kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__AVX2__)
+#include "avx2.h"
+
+// Speck128: 64-bit lanes, four blocks per register pair
+SS_INLINE __m256i ss_speck128_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi64x((long long)((const uint64_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck128_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    *x = _mm256_xor_si256(_mm256_add_epi64(ss_avx2_ror8_64(*x), *y), k);
+    *y = _mm256_xor_si256(_mm256_or_si256(_mm256_slli_epi64(*y, 3), _mm256_srli_epi64(*y, 61)), *x);
+}
+
+SS_INLINE void ss_speck128_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = _mm256_xor_si256(*y, *x);
+    *y = _mm256_or_si256(_mm256_srli_epi64(t, 3), _mm256_slli_epi64(t, 61));
+    *x = ss_avx2_rol8_64(_mm256_sub_epi64(_mm256_xor_si256(*x, k), *y));
+}
+
+#define SS_KERNEL ss_speck128_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 4
+#define SS_KERNEL_BLOCK 16
+#define SS_KERNEL_LOAD ss_avx2_load_64
+#define SS_KERNEL_STORE ss_avx2_store_64
+#include "kernel_impl.h"
+
+// Speck64: 32-bit lanes, eight blocks per register pair
+SS_INLINE __m256i ss_speck64_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi32((int)((const uint32_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck64_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    *x = _mm256_xor_si256(_mm256_add_epi32(ss_avx2_ror8_32(*x), *y), k);
+    *y = _mm256_xor_si256(_mm256_or_si256(_mm256_slli_epi32(*y, 3), _mm256_srli_epi32(*y, 29)), *x);
+}
+
+SS_INLINE void ss_speck64_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = _mm256_xor_si256(*y, *x);
+    *y = _mm256_or_si256(_mm256_srli_epi32(t, 3), _mm256_slli_epi32(t, 29));
+    *x = ss_avx2_rol8_32(_mm256_sub_epi32(_mm256_xor_si256(*x, k), *y));
+}
+
+#define SS_KERNEL ss_speck64_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 8
+#define SS_KERNEL_BLOCK 8
+#define SS_KERNEL_LOAD ss_avx2_load_32
+#define SS_KERNEL_STORE ss_avx2_store_32
+#include "kernel_impl.h"
+
+// Speck32: 16-bit lanes, sixteen blocks per register pair. Rotations are
+// 7 and 2 here, so shift/or throughout.
+SS_INLINE __m256i ss_speck32_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi16((short)((const uint16_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck32_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i r = _mm256_or_si256(_mm256_srli_epi16(*x, 7), _mm256_slli_epi16(*x, 9));
+    *x = _mm256_xor_si256(_mm256_add_epi16(r, *y), k);
+    *y = _mm256_xor_si256(_mm256_or_si256(_mm256_slli_epi16(*y, 2), _mm256_srli_epi16(*y, 14)), *x);
+}
+
+SS_INLINE void ss_speck32_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    __m256i t = _mm256_xor_si256(*y, *x);
+    *y = _mm256_or_si256(_mm256_srli_epi16(t, 2), _mm256_slli_epi16(t, 14));
+    t = _mm256_sub_epi16(_mm256_xor_si256(*x, k), *y);
+    *x = _mm256_or_si256(_mm256_slli_epi16(t, 7), _mm256_srli_epi16(t, 9));
+}
+
+#define SS_KERNEL ss_speck32_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 16
+#define SS_KERNEL_BLOCK 4
+#define SS_KERNEL_LOAD ss_avx2_load_16
+#define SS_KERNEL_STORE ss_avx2_store_16
+#include "kernel_impl.h"
+
+// Speck48: 24-bit words in 32-bit lanes, eight 6-byte blocks per register
+// pair. The bits above a word may hold carries: the byte rotation of x
+// clears them and y is masked once per round, before a shift can move
+// them into the word.
+SS_INLINE __m256i ss_speck48_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi32((int)((const uint32_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck48_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    const __m256i mask = _mm256_set1_epi32(0xffffff);
+    *x = _mm256_xor_si256(_mm256_add_epi32(ss_avx2_ror8_24(*x), *y), k);
+    *y = _mm256_or_si256(_mm256_slli_epi32(*y, 3), _mm256_srli_epi32(*y, 21));
+    *y = _mm256_and_si256(_mm256_xor_si256(*y, *x), mask);
+}
+
+SS_INLINE void ss_speck48_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    const __m256i mask = _mm256_set1_epi32(0xffffff);
+    __m256i t = _mm256_xor_si256(*y, *x);
+    *y = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi32(t, 3), _mm256_slli_epi32(t, 21)), mask);
+    *x = ss_avx2_rol8_24(_mm256_sub_epi32(_mm256_xor_si256(*x, k), *y));
+}
+
+#define SS_KERNEL ss_speck48_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 8
+#define SS_KERNEL_BLOCK 6
+#define SS_KERNEL_LOAD ss_avx2_load_24
+#define SS_KERNEL_STORE ss_avx2_store_24
+#include "kernel_impl.h"
+
+// Speck96: 48-bit words in 64-bit lanes, four 12-byte blocks per register
+// pair, masked like Speck48
+SS_INLINE __m256i ss_speck96_avx2_key(const void *schedule, unsigned i)
+{
+    return _mm256_set1_epi64x((long long)((const uint64_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck96_avx2_round(__m256i *x, __m256i *y, __m256i k)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xffffffffffff);
+    *x = _mm256_xor_si256(_mm256_add_epi64(ss_avx2_ror8_48(*x), *y), k);
+    *y = _mm256_or_si256(_mm256_slli_epi64(*y, 3), _mm256_srli_epi64(*y, 45));
+    *y = _mm256_and_si256(_mm256_xor_si256(*y, *x), mask);
+}
+
+SS_INLINE void ss_speck96_avx2_inverse_round(__m256i *x, __m256i *y, __m256i k)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xffffffffffff);
+    __m256i t = _mm256_xor_si256(*y, *x);
+    *y = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(t, 3), _mm256_slli_epi64(t, 45)), mask);
+    *x = ss_avx2_rol8_48(_mm256_sub_epi64(_mm256_xor_si256(*x, k), *y));
+}
+
+#define SS_KERNEL ss_speck96_avx2
+#define SS_KERNEL_TIER "avx2"
+#define SS_KERNEL_VEC __m256i
+#define SS_KERNEL_LANES 4
+#define SS_KERNEL_BLOCK 12
+#define SS_KERNEL_LOAD ss_avx2_load_48
+#define SS_KERNEL_STORE ss_avx2_store_48
+#include "kernel_impl.h"
+#endif
@@ -0,0 +1,129 @@
+/**
+* speck_avx512.c - AVX-512 Speck kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__AVX512F__)
+#include "avx512.h"
+
+// VPROLQ / VPROLD make every rotation a single instruction. Tails go
+// through one masked register pair, so no block falls back to scalar.
+
+// Speck128: 64-bit lanes, eight blocks per register pair
+SS_INLINE __m512i ss_speck128_avx512_key(const void *schedule, unsigned i)
+{
+    return _mm512_set1_epi64((long long)((const uint64_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck128_avx512_round(__m512i *x, __m512i *y, __m512i k)
+{
+    *x = _mm512_xor_si512(_mm512_add_epi64(_mm512_ror_epi64(*x, 8), *y), k);
+    *y = _mm512_xor_si512(_mm512_rol_epi64(*y, 3), *x);
+}
+
+SS_INLINE void ss_speck128_avx512_inverse_round(__m512i *x, __m512i *y, __m512i k)
+{
+    *y = _mm512_ror_epi64(_mm512_xor_si512(*y, *x), 3);
+    *x = _mm512_rol_epi64(_mm512_sub_epi64(_mm512_xor_si512(*x, k), *y), 8);
+}
+
+#define SS_KERNEL ss_speck128_avx512
+#define SS_KERNEL_TIER "avx512"
+#define SS_KERNEL_VEC __m512i
+#define SS_KERNEL_LANES 8
+#define SS_KERNEL_BLOCK 16
+#define SS_KERNEL_LOAD ss_avx512_load_64
+#define SS_KERNEL_STORE ss_avx512_store_64
+#define SS_KERNEL_LOAD_PARTIAL ss_avx512_load_partial_64
+#define SS_KERNEL_STORE_PARTIAL ss_avx512_store_partial_64
+#include "kernel_impl.h"
+
+// Speck64: 32-bit lanes, sixteen blocks per register pair
+SS_INLINE __m512i ss_speck64_avx512_key(const void *schedule, unsigned i)
+{
+    return _mm512_set1_epi32((int)((const uint32_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck64_avx512_round(__m512i *x, __m512i *y, __m512i k)
+{
+    *x = _mm512_xor_si512(_mm512_add_epi32(_mm512_ror_epi32(*x, 8), *y), k);
+    *y = _mm512_xor_si512(_mm512_rol_epi32(*y, 3), *x);
+}
+
+SS_INLINE void ss_speck64_avx512_inverse_round(__m512i *x, __m512i *y, __m512i k)
+{
+    *y = _mm512_ror_epi32(_mm512_xor_si512(*y, *x), 3);
+    *x = _mm512_rol_epi32(_mm512_sub_epi32(_mm512_xor_si512(*x, k), *y), 8);
+}
+
+#define SS_KERNEL ss_speck64_avx512
+#define SS_KERNEL_TIER "avx512"
+#define SS_KERNEL_VEC __m512i
+#define SS_KERNEL_LANES 16
+#define SS_KERNEL_BLOCK 8
+#define SS_KERNEL_LOAD ss_avx512_load_32
+#define SS_KERNEL_STORE ss_avx512_store_32
+#define SS_KERNEL_LOAD_PARTIAL ss_avx512_load_partial_32
+#define SS_KERNEL_STORE_PARTIAL ss_avx512_store_partial_32
+#include "kernel_impl.h"
+
+#if defined(__AVX512BW__)
+// Speck32: 16-bit lanes, thirty-two blocks per register pair. There is no
+// 16-bit rotate instruction, so shift/or on AVX512BW.
+SS_INLINE __m512i ss_speck32_avx512_key(const void *schedule, unsigned i)
+{
+    return _mm512_set1_epi16((short)((const uint16_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck32_avx512_round(__m512i *x, __m512i *y, __m512i k)
+{
+    __m512i r = _mm512_or_si512(_mm512_srli_epi16(*x, 7), _mm512_slli_epi16(*x, 9));
+    *x = _mm512_xor_si512(_mm512_add_epi16(r, *y), k);
+    *y = _mm512_xor_si512(_mm512_or_si512(_mm512_slli_epi16(*y, 2), _mm512_srli_epi16(*y, 14)), *x);
+}
+
+SS_INLINE void ss_speck32_avx512_inverse_round(__m512i *x, __m512i *y, __m512i k)
+{
+    __m512i t = _mm512_xor_si512(*y, *x);
+    *y = _mm512_or_si512(_mm512_srli_epi16(t, 2), _mm512_slli_epi16(t, 14));
+    t = _mm512_sub_epi16(_mm512_xor_si512(*x, k), *y);
+    *x = _mm512_or_si512(_mm512_slli_epi16(t, 7), _mm512_srli_epi16(t, 9));
+}
+
+#define SS_KERNEL ss_speck32_avx512
+#define SS_KERNEL_TIER "avx512"
+#define SS_KERNEL_VEC __m512i
+#define SS_KERNEL_LANES 32
+#define SS_KERNEL_BLOCK 4
+#define SS_KERNEL_LOAD ss_avx512_load_16
+#define SS_KERNEL_STORE ss_avx512_store_16
+#define SS_KERNEL_LOAD_PARTIAL ss_avx512_load_partial_16
+#define SS_KERNEL_STORE_PARTIAL ss_avx512_store_partial_16
+#include "kernel_impl.h"
+#endif
+#endif
@@ -0,0 +1,95 @@
+/**
+* speck_ssse3.c - SSSE3 Speck kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__SSSE3__)
+#include "ssse3.h"
+
+// The AVX2 kernels at half the width, for CPUs without AVX2. None for
+// Speck128: a two-lane kernel ran 980 MB/s against scalar's 1160.
+
+// Speck64: 32-bit lanes, four blocks per register pair
+SS_INLINE __m128i ss_speck64_ssse3_key(const void *schedule, unsigned i)
+{
+    return _mm_set1_epi32((int)((const uint32_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck64_ssse3_round(__m128i *x, __m128i *y, __m128i k)
+{
+    *x = _mm_xor_si128(_mm_add_epi32(ss_ssse3_ror8_32(*x), *y), k);
+    *y = _mm_xor_si128(_mm_or_si128(_mm_slli_epi32(*y, 3), _mm_srli_epi32(*y, 29)), *x);
+}
+
+SS_INLINE void ss_speck64_ssse3_inverse_round(__m128i *x, __m128i *y, __m128i k)
+{
+    __m128i t = _mm_xor_si128(*y, *x);
+    *y = _mm_or_si128(_mm_srli_epi32(t, 3), _mm_slli_epi32(t, 29));
+    *x = ss_ssse3_rol8_32(_mm_sub_epi32(_mm_xor_si128(*x, k), *y));
+}
+
+#define SS_KERNEL ss_speck64_ssse3
+#define SS_KERNEL_TIER "ssse3"
+#define SS_KERNEL_VEC __m128i
+#define SS_KERNEL_LANES 4
+#define SS_KERNEL_BLOCK 8
+#define SS_KERNEL_LOAD ss_ssse3_load_32
+#define SS_KERNEL_STORE ss_ssse3_store_32
+#include "kernel_impl.h"
+
+// Speck32: 16-bit lanes, eight blocks per register pair. Rotations are
+// 7 and 2 here, so shift/or throughout.
+SS_INLINE __m128i ss_speck32_ssse3_key(const void *schedule, unsigned i)
+{
+    return _mm_set1_epi16((short)((const uint16_t *)schedule)[i]);
+}
+
+SS_INLINE void ss_speck32_ssse3_round(__m128i *x, __m128i *y, __m128i k)
+{
+    __m128i r = _mm_or_si128(_mm_srli_epi16(*x, 7), _mm_slli_epi16(*x, 9));
+    *x = _mm_xor_si128(_mm_add_epi16(r, *y), k);
+    *y = _mm_xor_si128(_mm_or_si128(_mm_slli_epi16(*y, 2), _mm_srli_epi16(*y, 14)), *x);
+}
+
+SS_INLINE void ss_speck32_ssse3_inverse_round(__m128i *x, __m128i *y, __m128i k)
+{
+    __m128i t = _mm_xor_si128(*y, *x);
+    *y = _mm_or_si128(_mm_srli_epi16(t, 2), _mm_slli_epi16(t, 14));
+    t = _mm_sub_epi16(_mm_xor_si128(*x, k), *y);
+    *x = _mm_or_si128(_mm_slli_epi16(t, 7), _mm_srli_epi16(t, 9));
+}
+
+#define SS_KERNEL ss_speck32_ssse3
+#define SS_KERNEL_TIER "ssse3"
+#define SS_KERNEL_VEC __m128i
+#define SS_KERNEL_LANES 8
+#define SS_KERNEL_BLOCK 4
+#define SS_KERNEL_LOAD ss_ssse3_load_16
+#define SS_KERNEL_STORE ss_ssse3_store_16
+#include "kernel_impl.h"
+#endif
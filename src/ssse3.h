@@ -0,0 +1,97 @@
+/**
+* ssse3.h - SSSE3 helpers shared by the kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_SSSE3_H
+#define SIMONSPECK_SSSE3_H
+
+#include <tmmintrin.h>
+#include <stdint.h>
+
+#include "simonspeck_internal.h"
+
+// The 128-bit counterparts of avx2.h, without the 64-bit word helpers
+
+// Rotations by whole bytes are a byte shuffle within each lane
+SS_INLINE __m128i ss_ssse3_ror8_32(__m128i v)
+{
+    const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    return _mm_shuffle_epi8(v, shuffle);
+}
+
+SS_INLINE __m128i ss_ssse3_rol8_32(__m128i v)
+{
+    const __m128i shuffle = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    return _mm_shuffle_epi8(v, shuffle);
+}
+
+// Rotating a 16-bit lane by 8 either way swaps its bytes
+SS_INLINE __m128i ss_ssse3_rot8_16(__m128i v)
+{
+    const __m128i shuffle = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    return _mm_shuffle_epi8(v, shuffle);
+}
+
+// 32 bytes of blocks y || x <-> a vector of y words and one of x words
+
+// 32-bit words, 4 blocks: swapping the middle words pairs up y0 y1 x0 x1,
+// the 64-bit unpack then gathers the words
+SS_INLINE void ss_ssse3_load_32(const uint8_t *in, __m128i *x, __m128i *y)
+{
+    __m128i a = _mm_loadu_si128((const __m128i *)in);
+    __m128i b = _mm_loadu_si128((const __m128i *)(in + 16));
+    a = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+    *y = _mm_unpacklo_epi64(a, b);
+    *x = _mm_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_ssse3_store_32(uint8_t *out, __m128i x, __m128i y)
+{
+    __m128i a = _mm_shuffle_epi32(_mm_unpacklo_epi64(y, x), _MM_SHUFFLE(3, 1, 2, 0));
+    __m128i b = _mm_shuffle_epi32(_mm_unpackhi_epi64(y, x), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i *)out, a);
+    _mm_storeu_si128((__m128i *)(out + 16), b);
+}
+
+// 16-bit words, 8 blocks: a byte shuffle sorts each vector into y0..y3
+// x0..x3, the 64-bit unpack then gathers the words
+SS_INLINE void ss_ssse3_load_16(const uint8_t *in, __m128i *x, __m128i *y)
+{
+    const __m128i split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+    __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), split);
+    __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + 16)), split);
+    *y = _mm_unpacklo_epi64(a, b);
+    *x = _mm_unpackhi_epi64(a, b);
+}
+
+SS_INLINE void ss_ssse3_store_16(uint8_t *out, __m128i x, __m128i y)
+{
+    const __m128i merge = _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    _mm_storeu_si128((__m128i *)out, _mm_shuffle_epi8(_mm_unpacklo_epi64(y, x), merge));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm_shuffle_epi8(_mm_unpackhi_epi64(y, x), merge));
+}
+
+#endif
@@ -0,0 +1,102 @@
+/**
+* vec.h - Generic vector helpers shared by the portable kernels
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_VEC_H
+#define SIMONSPECK_VEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+// 16-byte gcc/clang generic vectors, one NEON, VSX or SSE2 register. Wider
+// ones would change the calling convention with the target's vector width.
+typedef uint64_t ss_v64 __attribute__((vector_size(16)));
+typedef uint32_t ss_v32 __attribute__((vector_size(16)));
+typedef uint16_t ss_v16 __attribute__((vector_size(16)));
+
+// Lanes of a and b, indices past the lanes of a pick from b
+#if defined(__clang__)
+#define SS_VEC_SHUFFLE(type, a, b, ...) __builtin_shufflevector(a, b, __VA_ARGS__)
+#else
+#define SS_VEC_SHUFFLE(type, a, b, ...) __builtin_shuffle(a, b, (type){__VA_ARGS__})
+#endif
+
+// 32 bytes of blocks y || x <-> a vector of y words and one of x words,
+// little endian lanes, in block order
+
+SS_INLINE void ss_vec_load_64(const uint8_t *in, ss_v64 *x, ss_v64 *y)
+{
+    ss_v64 a, b;
+    memcpy(&a, in, 16);
+    memcpy(&b, in + 16, 16);
+    *y = SS_VEC_SHUFFLE(ss_v64, a, b, 0, 2);
+    *x = SS_VEC_SHUFFLE(ss_v64, a, b, 1, 3);
+}
+
+SS_INLINE void ss_vec_store_64(uint8_t *out, ss_v64 x, ss_v64 y)
+{
+    ss_v64 a = SS_VEC_SHUFFLE(ss_v64, y, x, 0, 2);
+    ss_v64 b = SS_VEC_SHUFFLE(ss_v64, y, x, 1, 3);
+    memcpy(out, &a, 16);
+    memcpy(out + 16, &b, 16);
+}
+
+SS_INLINE void ss_vec_load_32(const uint8_t *in, ss_v32 *x, ss_v32 *y)
+{
+    ss_v32 a, b;
+    memcpy(&a, in, 16);
+    memcpy(&b, in + 16, 16);
+    *y = SS_VEC_SHUFFLE(ss_v32, a, b, 0, 2, 4, 6);
+    *x = SS_VEC_SHUFFLE(ss_v32, a, b, 1, 3, 5, 7);
+}
+
+SS_INLINE void ss_vec_store_32(uint8_t *out, ss_v32 x, ss_v32 y)
+{
+    ss_v32 a = SS_VEC_SHUFFLE(ss_v32, y, x, 0, 4, 1, 5);
+    ss_v32 b = SS_VEC_SHUFFLE(ss_v32, y, x, 2, 6, 3, 7);
+    memcpy(out, &a, 16);
+    memcpy(out + 16, &b, 16);
+}
+
+SS_INLINE void ss_vec_load_16(const uint8_t *in, ss_v16 *x, ss_v16 *y)
+{
+    ss_v16 a, b;
+    memcpy(&a, in, 16);
+    memcpy(&b, in + 16, 16);
+    *y = SS_VEC_SHUFFLE(ss_v16, a, b, 0, 2, 4, 6, 8, 10, 12, 14);
+    *x = SS_VEC_SHUFFLE(ss_v16, a, b, 1, 3, 5, 7, 9, 11, 13, 15);
+}
+
+SS_INLINE void ss_vec_store_16(uint8_t *out, ss_v16 x, ss_v16 y)
+{
+    ss_v16 a = SS_VEC_SHUFFLE(ss_v16, y, x, 0, 8, 1, 9, 2, 10, 3, 11);
+    ss_v16 b = SS_VEC_SHUFFLE(ss_v16, y, x, 4, 12, 5, 13, 6, 14, 7, 15);
+    memcpy(out, &a, 16);
+    memcpy(out + 16, &b, 16);
+}
+
+#endif
@@ -0,0 +1,176 @@
+/**
+* xts.c - XTS mode for the 128-bit block variants
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "simonspeck_internal.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+typedef __m128i ss_tweak;
+
+SS_INLINE ss_tweak ss_tweak_load(const uint8_t *p)
+{
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+SS_INLINE void ss_tweak_store(uint8_t *p, ss_tweak t)
+{
+    _mm_storeu_si128((__m128i *)p, t);
+}
+
+// Multiply by x in GF(2^128): every 32-bit lane shifts left and takes the
+// top bit of the lane below, the top bit of the whole value folds back in
+// as 0x87
+SS_INLINE ss_tweak ss_tweak_double(ss_tweak t)
+{
+    __m128i carry = _mm_and_si128(_mm_srai_epi32(t, 31), _mm_set_epi32(0x87, 1, 1, 1));
+    carry = _mm_shuffle_epi32(carry, _MM_SHUFFLE(2, 1, 0, 3));
+    return _mm_xor_si128(_mm_slli_epi32(t, 1), carry);
+}
+#else
+typedef struct {
+    uint64_t lo, hi;
+} ss_tweak;
+
+SS_INLINE ss_tweak ss_tweak_load(const uint8_t *p)
+{
+    ss_tweak t = { ss_load_le(p, 8), ss_load_le(p + 8, 8) };
+    return t;
+}
+
+SS_INLINE void ss_tweak_store(uint8_t *p, ss_tweak t)
+{
+    ss_store_le(p, t.lo, 8);
+    ss_store_le(p + 8, t.hi, 8);
+}
+
+SS_INLINE ss_tweak ss_tweak_double(ss_tweak t)
+{
+    uint64_t carry = t.hi >> 63;
+    t.hi = (t.hi << 1) | (t.lo >> 63);
+    t.lo = (t.lo << 1) ^ (0x87 & -carry);
+    return t;
+}
+#endif
+
+#define SS_XTS_BATCH (SS_BATCH_BYTES / 16)
+
+static int ss_xts_crypt(const simonspeck_ctx *data, const simonspeck_ctx *tweak,
+                        const uint64_t *sectors, size_t nsectors, size_t sector_bytes,
+                        const uint8_t *in, uint8_t *out, int decrypt)
+{
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t first[SS_BATCH_BYTES];
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t tweaks[SS_BATCH_BYTES];
+    SS_ALIGNED(SS_CACHE_LINE) uint8_t buf[SS_BATCH_BYTES];
+    size_t per_sector = sector_bytes / 16;
+
+    if (data->variant->block_size != 128 || tweak->variant->block_size != 128 ||
+        sector_bytes == 0 || sector_bytes % 16 != 0)
+    {
+        return SIMONSPECK_EINVAL;
+    }
+
+    for (size_t s = 0; s < nsectors; s += SS_XTS_BATCH)
+    {
+        size_t ns = nsectors - s < SS_XTS_BATCH ? nsectors - s : SS_XTS_BATCH;
+
+        // Initial tweaks of the whole group in one multi-block call
+        for (size_t i = 0; i < ns; i++)
+        {
+            ss_store_le(first + 16 * i, sectors[s + i], 8);
+            memset(first + 16 * i + 8, 0, 8);
+        }
+        ss_encrypt_blocks(tweak, first, first, ns);
+
+        // Blocks of consecutive sectors share batches, so small sectors
+        // still fill the kernel
+        size_t total = ns * per_sector;
+        ss_tweak t = ss_tweak_load(first);
+        for (size_t done = 0; done < total;)
+        {
+            size_t n = total - done < SS_XTS_BATCH ? total - done : SS_XTS_BATCH;
+
+            for (size_t i = 0; i < n; i++)
+            {
+                size_t j = done + i;
+                if (j % per_sector == 0)
+                {
+                    t = ss_tweak_load(first + 16 * (j / per_sector));
+                }
+                else
+                {
+                    t = ss_tweak_double(t);
+                }
+                ss_tweak_store(tweaks + 16 * i, t);
+            }
+
+            ss_xor(buf, in, tweaks, 16 * n);
+            if (decrypt)
+            {
+                ss_decrypt_blocks(data, buf, buf, n);
+            }
+            else
+            {
+                ss_encrypt_blocks(data, buf, buf, n);
+            }
+            ss_xor(out, buf, tweaks, 16 * n);
+
+            in += 16 * n;
+            out += 16 * n;
+            done += n;
+        }
+    }
+    return SIMONSPECK_OK;
+}
+
+int simonspeck_xts_encrypt(const simonspeck_ctx *data, const simonspeck_ctx *tweak, uint64_t sector,
+                           const uint8_t *in, uint8_t *out, size_t sector_bytes)
+{
+    return ss_xts_crypt(data, tweak, &sector, 1, sector_bytes, in, out, 0);
+}
+
+int simonspeck_xts_decrypt(const simonspeck_ctx *data, const simonspeck_ctx *tweak, uint64_t sector,
+                           const uint8_t *in, uint8_t *out, size_t sector_bytes)
+{
+    return ss_xts_crypt(data, tweak, &sector, 1, sector_bytes, in, out, 1);
+}
+
+int simonspeck_xts_encrypt_sectors(const simonspeck_ctx *data, const simonspeck_ctx *tweak,
+                                   const uint64_t *sectors, size_t nsectors, size_t sector_bytes,
+                                   const uint8_t *in, uint8_t *out)
+{
+    return ss_xts_crypt(data, tweak, sectors, nsectors, sector_bytes, in, out, 0);
+}
+
+int simonspeck_xts_decrypt_sectors(const simonspeck_ctx *data, const simonspeck_ctx *tweak,
+                                   const uint64_t *sectors, size_t nsectors, size_t sector_bytes,
+                                   const uint8_t *in, uint8_t *out)
+{
+    return ss_xts_crypt(data, tweak, sectors, nsectors, sector_bytes, in, out, 1);
+}
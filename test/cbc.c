@@ -0,0 +1,89 @@
+/**
+* cbc.c - CBC mode against a construction from single blocks
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+static const size_t lengths[] = {0, 1, 7, 15, 16, 17, 31, 100, 1030, 2100, 5000};
+
+static uint8_t in[8192], out[8192], want[8192];
+static unsigned checks;
+
+static void test_cbc(simonspeck_ctx *ctx, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u;
+    uint8_t iv[16], x[16];
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        size_t len = lengths[i] / block * block;
+        test_fill(iv, block, seed);
+
+        const uint8_t *chain = iv;
+        for (size_t b = 0; b < len; b += block)
+        {
+            for (size_t j = 0; j < block; j++)
+            {
+                x[j] = in[b + j] ^ chain[j];
+            }
+            simonspeck_encrypt(ctx, x, want + b);
+            chain = want + b;
+        }
+        CHECK(simonspeck_cbc_encrypt(ctx, iv, in, out, len) == SIMONSPECK_OK && memcmp(out, want, len) == 0,
+              "%s: cbc encrypt %zu bytes", v->name, len);
+        CHECK(simonspeck_cbc_decrypt(ctx, iv, out, out, len) == SIMONSPECK_OK && memcmp(out, in, len) == 0,
+              "%s: cbc decrypt %zu bytes in place", v->name, len);
+        memcpy(out, in, len);
+        CHECK(simonspeck_cbc_encrypt(ctx, iv, out, out, len) == SIMONSPECK_OK && memcmp(out, want, len) == 0,
+              "%s: cbc encrypt %zu bytes in place", v->name, len);
+        checks += 3;
+    }
+    CHECK(simonspeck_cbc_encrypt(ctx, iv, in, out, block + 1) == SIMONSPECK_EINVAL,
+          "%s: cbc partial block", v->name);
+    CHECK(simonspeck_cbc_decrypt(ctx, iv, in, out, block - 1) == SIMONSPECK_EINVAL,
+          "%s: cbc decrypt partial block", v->name);
+    checks += 2;
+}
+
+int main(void)
+{
+    uint32_t seed = 0x2545f491;
+
+    test_fill(in, sizeof(in), &seed);
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        uint8_t key[32];
+        test_fill(key, sizeof(key), &seed);
+        simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+        test_cbc(ctx, &seed);
+        simonspeck_free(ctx);
+    }
+    return test_summary("cbc", checks);
+}
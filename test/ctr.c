@@ -0,0 +1,137 @@
+/**
+* ctr.c - CTR mode against a construction from single blocks
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+static const size_t lengths[] = {0, 1, 7, 15, 16, 17, 31, 100, 1030, 2100, 5000};
+
+static uint8_t in[8192], out[8192], want[8192];
+static unsigned checks;
+
+// CTR from single block encryptions, the counter wraps inside its bytes
+static void ctr_reference(const simonspeck_ctx *ctx, const uint8_t *iv, unsigned counter_bytes,
+                          const uint8_t *src, uint8_t *dst, size_t len)
+{
+    size_t block = simonspeck_ctx_variant(ctx)->block_size / 8u;
+    uint8_t counter[16], ks[16];
+
+    memcpy(counter, iv, block);
+    for (size_t i = 0; i < len; i++)
+    {
+        if (i % block == 0)
+        {
+            simonspeck_encrypt(ctx, counter, ks);
+            for (size_t j = block; j-- > block - counter_bytes && ++counter[j] == 0;)
+            {
+            }
+        }
+        dst[i] = src[i] ^ ks[i % block];
+    }
+}
+
+static void test_ctr(simonspeck_ctx *ctx, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u;
+    uint8_t iv[16];
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        size_t len = lengths[i];
+        test_fill(iv, block, seed);
+        memset(iv + block - 4, 0, 4);
+        ctr_reference(ctx, iv, 4, in, want, len);
+        CHECK(simonspeck_ctr(ctx, iv, 4, in, out, len) == SIMONSPECK_OK && memcmp(out, want, len) == 0,
+              "%s: ctr %zu bytes", v->name, len);
+        memcpy(out, in, len);
+        CHECK(simonspeck_ctr(ctx, iv, 4, out, out, len) == SIMONSPECK_OK && memcmp(out, want, len) == 0,
+              "%s: ctr %zu bytes in place", v->name, len);
+        checks += 2;
+    }
+
+    CHECK(simonspeck_ctr(ctx, iv, 0, in, out, 0) == SIMONSPECK_EINVAL, "%s: ctr no counter", v->name);
+    CHECK(simonspeck_ctr(ctx, iv, (unsigned)block + 1, in, out, 0) == SIMONSPECK_EINVAL,
+          "%s: ctr counter too wide", v->name);
+    checks += 2;
+}
+
+// Every counter width up to the whole block: all ones leaves exactly one
+// block, and one below that two
+static void test_ctr_wrap(simonspeck_ctx *ctx, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u;
+    uint8_t iv[16];
+
+    for (unsigned width = 1; width <= block; width++)
+    {
+        test_fill(iv, block, seed);
+        memset(iv + block - width, 0xff, width);
+        ctr_reference(ctx, iv, width, in, want, block);
+        CHECK(simonspeck_ctr(ctx, iv, width, in, out, block) == SIMONSPECK_OK && memcmp(out, want, block) == 0,
+              "%s: ctr width %u last block", v->name, width);
+        CHECK(simonspeck_ctr(ctx, iv, width, in, out, block + 1) == SIMONSPECK_ERANGE,
+              "%s: ctr width %u wrap", v->name, width);
+
+        iv[block - 1] = 0xfe;
+        CHECK(simonspeck_ctr(ctx, iv, width, in, out, 2 * block) == SIMONSPECK_OK &&
+              simonspeck_ctr(ctx, iv, width, in, out, 2 * block + 1) == SIMONSPECK_ERANGE,
+              "%s: ctr width %u two blocks left", v->name, width);
+        checks += 3;
+
+        // Wider than 64 bits: the low 8 bytes carry into the ninth
+        if (width > 8)
+        {
+            iv[block - 1] = 0xff;
+            iv[block - 9] = 0x00;
+            ctr_reference(ctx, iv, width, in, want, 3 * block);
+            CHECK(simonspeck_ctr(ctx, iv, width, in, out, 3 * block) == SIMONSPECK_OK &&
+                  memcmp(out, want, 3 * block) == 0, "%s: ctr width %u carry past 64 bits", v->name, width);
+            checks++;
+        }
+    }
+}
+
+int main(void)
+{
+    uint32_t seed = 0x2545f491;
+
+    test_fill(in, sizeof(in), &seed);
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        uint8_t key[32];
+        test_fill(key, sizeof(key), &seed);
+        simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+        test_ctr(ctx, &seed);
+        test_ctr_wrap(ctx, &seed);
+        simonspeck_free(ctx);
+    }
+    return test_summary("ctr", checks);
+}
@@ -0,0 +1,91 @@
+/**
+* ecb.c - The multi-block ECB calls against single blocks and the paper
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "vectors.h"
+
+// The counts around the two pair and one pair steps of the kernels, and
+// the tails under them
+static const size_t counts[] = {127, 128, 129, 255, 256, 257, 300, 511, 512, 513};
+
+int main(void)
+{
+    unsigned checks = 0;
+    uint32_t seed = 0x9e3779b9;
+
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        uint8_t key[32];
+        test_fill(key, sizeof(key), &seed);
+        simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+
+        for (size_t offset = 0; offset < 2; offset++)
+        {
+            for (size_t n = 0; n <= 80; n++)
+            {
+                checks += test_blocks(ctx, n, offset, &seed);
+            }
+            for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+            {
+                checks += test_blocks(ctx, counts[i], offset, &seed);
+            }
+        }
+        simonspeck_free(ctx);
+    }
+
+    // Many copies of a paper block in one call
+    for (size_t v = 0; v < TEST_PAPER_COUNT; v++)
+    {
+        struct test_vector tv = test_paper_vector(v);
+        uint8_t in[64 * 16], out[64 * 16];
+        simonspeck_ctx *ctx = simonspeck_new(tv.variant->id, tv.key);
+        for (size_t n = 1; n <= 64; n += 21)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                memcpy(in + i * tv.block_bytes, tv.plaintext, tv.block_bytes);
+            }
+            simonspeck_encrypt_blocks(ctx, in, out, n);
+            int ok = 1;
+            for (size_t i = 0; i < n; i++)
+            {
+                ok &= memcmp(out + i * tv.block_bytes, tv.ciphertext, tv.block_bytes) == 0;
+            }
+            simonspeck_decrypt_blocks(ctx, out, out, n);
+            CHECK(ok && memcmp(out, in, n * tv.block_bytes) == 0, "%s: paper vector in %zu blocks",
+                  tv.variant->name, n);
+            checks++;
+        }
+        simonspeck_free(ctx);
+    }
+
+    return test_summary("ecb", checks);
+}
@@ -0,0 +1,63 @@
+/**
+* engine.hpp - A C++ engine checked against the C library
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_TEST_ENGINE_HPP
+#define SIMONSPECK_TEST_ENGINE_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include "test.h"
+
+// Parameters against the registry, then random keys and blocks against
+// simonspeck_encrypt and back through decrypt
+template <typename Cipher>
+unsigned check_engine(simonspeck_variant_id id, std::uint32_t *seed)
+{
+    const simonspeck_variant *v = &simonspeck_variants[id];
+    unsigned checks = 1;
+    CHECK(Cipher::block_bytes * 8 == v->block_size && Cipher::key_bytes * 8 == v->key_size &&
+          Cipher::rounds == v->rounds, "%s: parameters", v->name);
+
+    for (int i = 0; i < 100; i++) {
+        std::uint8_t key[32], pt[16], ct[16], want[16], back[16];
+        test_fill(key, sizeof(key), seed);
+        test_fill(pt, sizeof(pt), seed);
+
+        Cipher cipher(key);
+        simonspeck_ctx *ctx = simonspeck_new(id, key);
+        cipher.encrypt(pt, ct);
+        simonspeck_encrypt(ctx, pt, want);
+        cipher.decrypt(ct, back);
+        CHECK(std::memcmp(ct, want, Cipher::block_bytes) == 0, "%s: encrypt", v->name);
+        CHECK(std::memcmp(back, pt, Cipher::block_bytes) == 0, "%s: decrypt", v->name);
+        simonspeck_free(ctx);
+        checks += 2;
+    }
+    return checks;
+}
+
+#endif
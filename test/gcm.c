@@ -0,0 +1,112 @@
+/**
+* gcm.c - GCM against fixed vectors
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+// Vectors come from an independent Python model of GCM over the paper's
+// cipher definitions. Inputs are byte patterns:
+// key[i] = i, iv[i] = 0xa0 + i, aad[i] = 0xc0 + 3i, plaintext[i] = 3 + 7i.
+static const struct {
+    const char *name;
+    size_t len, aad_len, iv_len, tag_len;
+    const char *ciphertext, *tag;
+} gcm_vectors[] = {
+    {"speck128_128", 0, 0, 12, 16, "", "e8bc9ca43b26050471bbd84fd91c9904"},
+    {"speck128_128", 37, 13, 12, 16,
+     "0646a7eecab249d68e994926b78b298b221e710d55a3ce0d8bbf15549522326a8cf39fb8b4",
+     "c4b35bb77dde277808ac9cc1836e76a5"},
+    {"speck128_128", 64, 20, 8, 12,
+     "b857425cba6053f051637b6db405136bb85b42cbc6d455e7c4d435a53f1d0669"
+     "c0b6e1ed26882a725ebc2ed6c83b69ca1901be81eb7268e918d52ac3dfe30b14",
+     "9e89a9924969a366ba50b862"},
+    {"simon128_128", 0, 0, 12, 16, "", "6e6e7e9f7d782b9058713801a9a25c4c"},
+    {"simon128_128", 37, 13, 12, 16,
+     "ed508971058472aca62c3276efe99bc2fb859f4eecc184c0651298d0aebb7c3bef81227c00",
+     "1cd55d364c4babc5562e68bd13158b9f"},
+    {"simon128_128", 64, 20, 8, 12,
+     "3502fd560b01aa15548b81f3c342c20bbf84f52d3bb10b32898e38b07810d67d"
+     "5d83876106fb89ec51ff65411a830311ec07b37976f2ae11f03d250c64362aa5",
+     "be9f68a34621c0be2da7a875"},
+};
+
+static uint8_t in[8192], out[8192], tmp[8192];
+static unsigned checks;
+
+static void test_gcm(void)
+{
+    uint8_t key[32], iv[16], aad[32], tag[16];
+    test_pattern(key, sizeof(key), 0, 1);
+    test_pattern(iv, sizeof(iv), 0xa0, 1);
+    test_pattern(aad, sizeof(aad), 0xc0, 3);
+    test_pattern(in, 64, 3, 7);
+
+    for (size_t i = 0; i < sizeof(gcm_vectors) / sizeof(gcm_vectors[0]); i++)
+    {
+        const char *name = gcm_vectors[i].name;
+        size_t len = gcm_vectors[i].len, aad_len = gcm_vectors[i].aad_len;
+        size_t iv_len = gcm_vectors[i].iv_len, tag_len = gcm_vectors[i].tag_len;
+        simonspeck_gcm *gcm = simonspeck_gcm_new(simonspeck_find_variant(name)->id, key);
+
+        CHECK(simonspeck_gcm_seal(gcm, iv, iv_len, aad, aad_len, in, out, len, tag, tag_len) == SIMONSPECK_OK &&
+              test_equal_hex(out, len, gcm_vectors[i].ciphertext) &&
+              test_equal_hex(tag, tag_len, gcm_vectors[i].tag), "%s: gcm vector %zu", name, i);
+        CHECK(simonspeck_gcm_open(gcm, iv, iv_len, aad, aad_len, out, tmp, len, tag, tag_len) == SIMONSPECK_OK &&
+              memcmp(tmp, in, len) == 0, "%s: gcm open %zu", name, i);
+
+        // A flipped tag bit fails and zeroes the output
+        tag[0] ^= 1;
+        memset(tmp, 0xaa, len);
+        CHECK(simonspeck_gcm_open(gcm, iv, iv_len, aad, aad_len, out, tmp, len, tag, tag_len) == SIMONSPECK_EAUTH,
+              "%s: gcm tampered tag %zu", name, i);
+        for (size_t j = 0; j < len; j++)
+        {
+            CHECK(tmp[j] == 0, "%s: gcm output not zeroed at %zu", name, j);
+        }
+        tag[0] ^= 1;
+        if (len > 0)
+        {
+            out[len - 1] ^= 0x80;
+            CHECK(simonspeck_gcm_open(gcm, iv, iv_len, aad, aad_len, out, tmp, len, tag, tag_len) ==
+                  SIMONSPECK_EAUTH, "%s: gcm tampered ciphertext %zu", name, i);
+            checks++;
+        }
+        checks += 3 + (unsigned)len;
+        simonspeck_gcm_free(gcm);
+    }
+
+    CHECK(simonspeck_gcm_new(SPECK_96_64, key) == NULL, "gcm 64-bit blocks");
+    checks++;
+}
+
+int main(void)
+{
+    test_gcm();
+    return test_summary("gcm", checks);
+}
@@ -0,0 +1,106 @@
+/**
+* hctr2.c - HCTR2 against fixed vectors
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+// Vectors come from an independent Python model of HCTR2 over the paper's
+// cipher definitions. Key[i] = i, tweak[i] = 0xa0 + i, plaintext[i] = 3 + 7i.
+static const struct {
+    const char *name;
+    size_t len, tweak_len;
+    const char *ciphertext;
+} hctr2_vectors[] = {
+    {"speck128_128", 16, 0, "b601bb5704a1ef61440c96b51576712f"},
+    {"speck128_128", 47, 32,
+     "20064406dd3dfa29894d55526b9505d67e92f34f5787d3f656c551ffc8de6470"
+     "d065b7b64d89d5bc4bc67fcc082d7f"},
+    {"speck128_128", 64, 5,
+     "3a5eb3b967c89f5761042a4d71db4c314c8d1f8711cdc2c1d33e44764134e83b"
+     "4ad16edd79c69ac9e63f31593118ad1c9a2595fd02e3d5e41d8b494f8394a787"},
+    {"simon128_128", 16, 0, "e1b2da5309d72f42bc8fa468b063dd15"},
+    {"simon128_128", 47, 32,
+     "832e6a753e5a53acbbd6d40364794fe985ac3b015db8fb7a83ecbee56ce95170"
+     "5d37ad0de65c3dd94c40ead134b196"},
+    {"simon128_128", 64, 5,
+     "d981aaf3e3858424dea62080791a25a6bc08aef51f3a6b62d67c9b31376342f7"
+     "da01b96c254cea65a4763cfdd557ec7c078843b58fd758aef95a90ba9c1e9e6b"},
+};
+
+static const size_t lengths[] = {0, 1, 7, 15, 16, 17, 31, 100, 1030, 2100, 5000};
+
+static uint8_t in[8192], out[8192];
+static unsigned checks;
+
+static void test_hctr2(void)
+{
+    uint8_t key[32], tweak[32];
+    test_pattern(key, sizeof(key), 0, 1);
+    test_pattern(tweak, sizeof(tweak), 0xa0, 1);
+    test_pattern(in, 64, 3, 7);
+
+    for (size_t i = 0; i < sizeof(hctr2_vectors) / sizeof(hctr2_vectors[0]); i++)
+    {
+        const char *name = hctr2_vectors[i].name;
+        size_t len = hctr2_vectors[i].len, tweak_len = hctr2_vectors[i].tweak_len;
+        simonspeck_hctr2 *hctr2 = simonspeck_hctr2_new(simonspeck_find_variant(name)->id, key);
+
+        CHECK(simonspeck_hctr2_encrypt(hctr2, tweak, tweak_len, in, out, len) == SIMONSPECK_OK &&
+              test_equal_hex(out, len, hctr2_vectors[i].ciphertext), "%s: hctr2 vector %zu", name, i);
+        CHECK(simonspeck_hctr2_decrypt(hctr2, tweak, tweak_len, out, out, len) == SIMONSPECK_OK &&
+              memcmp(out, in, len) == 0, "%s: hctr2 decrypt %zu", name, i);
+        CHECK(simonspeck_hctr2_encrypt(hctr2, tweak, tweak_len, in, out, 15) == SIMONSPECK_EINVAL,
+              "%s: hctr2 short message", name);
+        checks += 3;
+        simonspeck_hctr2_free(hctr2);
+    }
+
+    // Long messages round trip
+    simonspeck_hctr2 *hctr2 = simonspeck_hctr2_new(SPECK_256_128, key);
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        size_t len = lengths[i];
+        if (len < 16)
+        {
+            continue;
+        }
+        test_pattern(in, len, 9, 5);
+        simonspeck_hctr2_encrypt(hctr2, tweak, 17, in, out, len);
+        CHECK(simonspeck_hctr2_decrypt(hctr2, tweak, 17, out, out, len) == SIMONSPECK_OK &&
+              memcmp(out, in, len) == 0, "hctr2 round trip %zu bytes", len);
+        checks++;
+    }
+    simonspeck_hctr2_free(hctr2);
+}
+
+int main(void)
+{
+    test_hctr2();
+    return test_summary("hctr2", checks);
+}
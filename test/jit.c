@@ -0,0 +1,106 @@
+/**
+* jit.c - The key-specialized kernel checked against the reference programs
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+// Built twice, against speck/128_128 and simon/128_128: the reference
+// programs define the same globals so they cannot share a binary. Their
+// main() is renamed out of the way.
+#define main reference_main
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wparentheses"
+#if defined(JIT_SIMON)
+#include "../simon/128_128/simon128_128.c"
+#define REFERENCE_EXPAND expand_simon_128_128
+#define REFERENCE_ENCRYPT encrypt_simon_128_128
+#define JIT_VARIANT SIMON_128_128
+#else
+#include "../speck/128_128/speck128_128.c"
+#define REFERENCE_EXPAND expand_speck
+#define REFERENCE_ENCRYPT encrypt_speck_128_128
+#define JIT_VARIANT SPECK_128_128
+#endif
+#pragma GCC diagnostic pop
+#undef main
+
+// More than a few loop iterations, and every count that is not a
+// multiple of the eight blocks per iteration
+#define MAX_BLOCKS 100
+
+static uint8_t in[16 * MAX_BLOCKS + 1], out[16 * MAX_BLOCKS + 1], want[16 * MAX_BLOCKS];
+
+int main(void)
+{
+    unsigned checks = 0, compiled = 0;
+    uint32_t seed = 0x510e527f;
+
+    for (int k = 0; k < 20; k++)
+    {
+        uint8_t key[16], schedule[8 * 68];
+        test_fill(key, sizeof(key), &seed);
+        REFERENCE_EXPAND(key, schedule);
+
+        simonspeck_ctx *ctx = simonspeck_new(JIT_VARIANT, key);
+        int ret = simonspeck_jit(ctx);
+#if defined(JIT_SIMON)
+        CHECK(ret == SIMONSPECK_EINVAL && strcmp(simonspeck_ctx_tier(ctx), "jit") != 0, "simon compiled");
+        checks++;
+#else
+        compiled += ret == SIMONSPECK_OK;
+#endif
+
+        for (size_t n = 0; n <= MAX_BLOCKS; n++)
+        {
+            for (size_t offset = 0; offset < 2; offset++)
+            {
+                test_fill(in + offset, 16 * n, &seed);
+                for (size_t b = 0; b < n; b++)
+                {
+                    REFERENCE_ENCRYPT(schedule, in + offset + 16 * b, want + 16 * b);
+                }
+
+                simonspeck_encrypt_blocks(ctx, in + offset, out + offset, n);
+                CHECK(memcmp(out + offset, want, 16 * n) == 0, "%s key %d: %zu blocks at +%zu",
+                      simonspeck_ctx_tier(ctx), k, n, offset);
+                simonspeck_decrypt_blocks(ctx, out + offset, out + offset, n);
+                CHECK(memcmp(out + offset, in + offset, 16 * n) == 0, "%s key %d: decrypt %zu blocks",
+                      simonspeck_ctx_tier(ctx), k, n);
+                checks += 2;
+            }
+        }
+        simonspeck_free(ctx);
+    }
+
+    // The JIT only runs where AVX2 is the best tier, SIMONSPECK_TIER=avx2
+    // forces that on AVX-512 machines
+    printf("%u of 20 keys compiled\n", compiled);
+    return test_summary("jit", checks);
+}
@@ -0,0 +1,81 @@
+/**
+* kat.c - The variant registry and contexts against the paper vectors
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "vectors.h"
+
+int main(void)
+{
+    unsigned checks = 0;
+
+    printf("Test the paper vectors through a context\n");
+    for (size_t v = 0; v < TEST_PAPER_COUNT; v++)
+    {
+        struct test_vector tv = test_paper_vector(v);
+        const simonspeck_variant *variant = tv.variant;
+        CHECK(variant != NULL, "%s: unknown variant", test_paper[v].name);
+        if (variant == NULL)
+        {
+            continue;
+        }
+
+        uint8_t *key = tv.key, *pt = tv.plaintext, *ct = tv.ciphertext, out[16];
+        size_t block = tv.block_bytes;
+        CHECK(tv.key_bytes == variant->key_size / 8u && block == variant->block_size / 8u,
+              "%s: vector sizes", variant->name);
+
+        simonspeck_ctx *ctx = simonspeck_new(variant->id, key);
+        CHECK(simonspeck_ctx_variant(ctx) == variant, "%s: context variant", variant->name);
+        simonspeck_encrypt(ctx, pt, out);
+        CHECK(memcmp(out, ct, block) == 0, "%s: encrypt", variant->name);
+        simonspeck_decrypt(ctx, ct, out);
+        CHECK(memcmp(out, pt, block) == 0, "%s: decrypt", variant->name);
+
+        printf("%-14s %s\n", variant->name, simonspeck_ctx_tier(ctx));
+        simonspeck_free(ctx);
+        checks += 4;
+    }
+
+    // Ids are ABI: new variants only ever go at the end
+    CHECK(SIMON_64_32 == 0 && SIMON_256_128 == 8 && SPECK_64_32 == 9 && SPECK_256_128 == 18 &&
+          SIMON_96_48 == 19, "variant ids moved");
+    CHECK(simonspeck_find_variant("speck1_1") == NULL, "unknown name");
+    checks += 2;
+
+    // Every entry sits at its id and is found by its name
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        const simonspeck_variant *v = &simonspeck_variants[id];
+        CHECK(v->id == (simonspeck_variant_id)id && simonspeck_find_variant(v->name) == v, "%s: registry entry",
+              v->name);
+        checks++;
+    }
+    return test_summary("kat", checks);
+}
@@ -0,0 +1,158 @@
+/**
+* kernels.c - Each SIMD kernel is picked under its tier and matches the single block path
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+// Tier names from slowest to fastest, as SIMONSPECK_TIER takes them
+static const char *const tiers[] = {"scalar", "bitslice", "vec", "ssse3", "avx2", "avx512"};
+
+#define TIER_COUNT (sizeof(tiers) / sizeof(tiers[0]))
+
+// The kernels: every variant of the cipher and word size runs on the tier
+static const struct {
+    const char *tier;
+    simonspeck_cipher cipher;
+    unsigned word_size;
+} kernels[] = {
+    {"avx2", SIMONSPECK_SPECK, 64},
+    {"avx2", SIMONSPECK_SPECK, 32},
+    {"avx2", SIMONSPECK_SPECK, 16},
+    {"avx2", SIMONSPECK_SIMON, 16},
+    {"avx512", SIMONSPECK_SPECK, 64},
+    {"avx512", SIMONSPECK_SPECK, 32},
+    {"avx512", SIMONSPECK_SPECK, 16},
+    {"avx512", SIMONSPECK_SIMON, 64},
+    {"avx512", SIMONSPECK_SIMON, 32},
+    {"avx2", SIMONSPECK_SIMON, 64},
+    {"avx2", SIMONSPECK_SIMON, 32},
+    {"bitslice", SIMONSPECK_SIMON, 16},
+    {"bitslice", SIMONSPECK_SIMON, 24},
+    {"avx2", SIMONSPECK_SPECK, 48},
+    {"avx2", SIMONSPECK_SPECK, 24},
+    {"avx2", SIMONSPECK_SIMON, 48},
+    {"ssse3", SIMONSPECK_SPECK, 32},
+    {"ssse3", SIMONSPECK_SPECK, 16},
+    {"ssse3", SIMONSPECK_SIMON, 32},
+    {"ssse3", SIMONSPECK_SIMON, 16},
+    {"vec", SIMONSPECK_SPECK, 64},
+    {"vec", SIMONSPECK_SPECK, 32},
+    {"vec", SIMONSPECK_SPECK, 16},
+    {"vec", SIMONSPECK_SIMON, 64},
+    {"vec", SIMONSPECK_SIMON, 32},
+    {"vec", SIMONSPECK_SIMON, 16},
+};
+
+static size_t tier_index(const char *name)
+{
+    for (size_t i = 0; i < TIER_COUNT; i++)
+    {
+        if (strcmp(name, tiers[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return TIER_COUNT;
+}
+
+// Whether this machine runs a tier at all
+static int tier_runs(const char *name)
+{
+    if (strcmp(name, "scalar") == 0 || strcmp(name, "bitslice") == 0)
+    {
+        return 1;
+    }
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (strcmp(name, "vec") == 0)
+    {
+        return 1;
+    }
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (strcmp(name, "ssse3") == 0)
+    {
+        return __builtin_cpu_supports("ssse3");
+    }
+    if (strcmp(name, "avx2") == 0)
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+    if (strcmp(name, "avx512") == 0)
+    {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+#endif
+    return 0;
+}
+
+int main(void)
+{
+    unsigned checks = 0;
+    uint32_t seed = 0x85ebca6b;
+    const char *cap = getenv("SIMONSPECK_TIER");
+    size_t top = cap != NULL ? tier_index(cap) : TIER_COUNT - 1;
+
+    // Unknown names fail closed to scalar
+    top = top < TIER_COUNT ? top : 0;
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        const simonspeck_variant *v = &simonspeck_variants[id];
+        uint8_t key[32];
+        test_fill(key, sizeof(key), &seed);
+        simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+        const char *tier = simonspeck_ctx_tier(ctx);
+
+        // Never above the cap, and a kernel of the capped tier when there
+        // is one and the CPU runs it
+        CHECK(tier_index(tier) <= top, "%s: %s above the %s cap", v->name, tier, tiers[top]);
+        checks++;
+        for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+        {
+            if (kernels[k].cipher == v->cipher && kernels[k].word_size == v->word_size &&
+                tier_index(kernels[k].tier) == top && tier_runs(kernels[k].tier))
+            {
+                CHECK(strcmp(tier, kernels[k].tier) == 0, "%s: %s kernel, got %s", v->name, kernels[k].tier, tier);
+                checks++;
+            }
+        }
+
+        for (size_t offset = 0; offset < 2; offset++)
+        {
+            for (size_t n = 0; n <= 40; n++)
+            {
+                checks += test_blocks(ctx, n, offset, &seed);
+            }
+            checks += test_blocks(ctx, 257, offset, &seed);
+        }
+        simonspeck_free(ctx);
+    }
+    return test_summary("kernels", checks);
+}
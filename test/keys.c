@@ -0,0 +1,90 @@
+/**
+* keys.c - Batched re-keying against one context per key
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+// Three batches of lanes, the last one partial
+#define KEYS 19
+#define BLOCKS 4
+
+int main(void)
+{
+    unsigned checks = 0;
+    uint32_t seed = 0x27d4eb2f;
+
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        const simonspeck_variant *v = &simonspeck_variants[id];
+        size_t len = BLOCKS * v->block_size / 8u;
+        uint8_t key[KEYS][32], zero[32] = {0}, pt[BLOCKS * 16], out[BLOCKS * 16], want[BLOCKS * 16];
+        simonspeck_ctx *ctxs[KEYS];
+        const uint8_t *keys[KEYS];
+
+        for (int i = 0; i < KEYS; i++)
+        {
+            test_fill(key[i], sizeof(key[i]), &seed);
+            ctxs[i] = simonspeck_new((simonspeck_variant_id)id, zero);
+            keys[i] = key[i];
+        }
+        CHECK(simonspeck_set_keys(ctxs, keys, KEYS) == SIMONSPECK_OK, "%s: set_keys", v->name);
+        checks++;
+        for (int i = 0; i < KEYS; i++)
+        {
+            simonspeck_ctx *ref = simonspeck_new((simonspeck_variant_id)id, key[i]);
+            test_fill(pt, len, &seed);
+            simonspeck_encrypt_blocks(ref, pt, want, BLOCKS);
+            simonspeck_encrypt_blocks(ctxs[i], pt, out, BLOCKS);
+            CHECK(memcmp(out, want, len) == 0, "%s: set_keys context %d", v->name, i);
+            simonspeck_decrypt_blocks(ctxs[i], out, out, BLOCKS);
+            CHECK(memcmp(out, pt, len) == 0, "%s: set_keys context %d decrypt", v->name, i);
+            checks += 2;
+            simonspeck_free(ref);
+        }
+
+        // One context of another variant refuses the whole batch
+        simonspeck_ctx *other = simonspeck_new((simonspeck_variant_id)((id + 1) % SIMONSPECK_VARIANT_COUNT), zero);
+        simonspeck_ctx *mixed[3] = {ctxs[0], other, ctxs[1]};
+        const uint8_t *zeros[3] = {zero, zero, zero};
+        simonspeck_ctx *ref = simonspeck_new((simonspeck_variant_id)id, key[0]);
+        CHECK(simonspeck_set_keys(mixed, zeros, 3) == SIMONSPECK_EINVAL, "%s: set_keys mixed variants", v->name);
+        simonspeck_encrypt_blocks(ref, pt, want, BLOCKS);
+        simonspeck_encrypt_blocks(ctxs[0], pt, out, BLOCKS);
+        CHECK(memcmp(out, want, len) == 0, "%s: set_keys mixed variants changed a key", v->name);
+        checks += 2;
+        simonspeck_free(ref);
+        simonspeck_free(other);
+
+        for (int i = 0; i < KEYS; i++)
+        {
+            simonspeck_free(ctxs[i]);
+        }
+    }
+    return test_summary("keys", checks);
+}
@@ -0,0 +1,79 @@
+/**
+* once.c - One-shot encryption without a stored schedule
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "vectors.h"
+
+#define KEYS 50
+
+int main(void)
+{
+    unsigned checks = 0;
+    uint32_t seed = 0x165667b1;
+
+    // The paper vectors, then random keys against a context
+    for (size_t v = 0; v < TEST_PAPER_COUNT; v++)
+    {
+        struct test_vector tv = test_paper_vector(v);
+        uint8_t out[16];
+        CHECK(simonspeck_encrypt_once(tv.variant->id, tv.key, tv.plaintext, out) == SIMONSPECK_OK &&
+              memcmp(out, tv.ciphertext, tv.block_bytes) == 0, "%s: encrypt_once", tv.variant->name);
+        CHECK(simonspeck_decrypt_once(tv.variant->id, tv.key, tv.ciphertext, out) == SIMONSPECK_OK &&
+              memcmp(out, tv.plaintext, tv.block_bytes) == 0, "%s: decrypt_once", tv.variant->name);
+        checks += 2;
+    }
+
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        const simonspeck_variant *v = &simonspeck_variants[id];
+        size_t block = v->block_size / 8u;
+        for (int i = 0; i < KEYS; i++)
+        {
+            uint8_t key[32], pt[16], want[16], out[16];
+            test_fill(key, sizeof(key), &seed);
+            test_fill(pt, block, &seed);
+            simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+            simonspeck_encrypt(ctx, pt, want);
+            simonspeck_free(ctx);
+
+            CHECK(simonspeck_encrypt_once((simonspeck_variant_id)id, key, pt, out) == SIMONSPECK_OK &&
+                  memcmp(out, want, block) == 0, "%s: encrypt_once key %d", v->name, i);
+            CHECK(simonspeck_decrypt_once((simonspeck_variant_id)id, key, out, out) == SIMONSPECK_OK &&
+                  memcmp(out, pt, block) == 0, "%s: decrypt_once key %d in place", v->name, i);
+            checks += 2;
+        }
+    }
+
+    CHECK(simonspeck_encrypt_once(SIMONSPECK_VARIANT_COUNT, NULL, NULL, NULL) == SIMONSPECK_EINVAL &&
+          simonspeck_decrypt_once(SIMONSPECK_VARIANT_COUNT, NULL, NULL, NULL) == SIMONSPECK_EINVAL,
+          "once unknown id");
+    checks++;
+    return test_summary("once", checks);
+}
@@ -0,0 +1,80 @@
+/**
+* reverse.c - Decryption from the reverse key without a stored schedule
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "vectors.h"
+
+#define KEYS 50
+
+int main(void)
+{
+    unsigned checks = 0;
+    uint32_t seed = 0xd3a2646c;
+
+    for (size_t v = 0; v < TEST_PAPER_COUNT; v++)
+    {
+        struct test_vector tv = test_paper_vector(v);
+        uint8_t rkey[32], out[16];
+        CHECK(simonspeck_reverse_key(tv.variant->id, tv.key, rkey) == SIMONSPECK_OK &&
+              simonspeck_decrypt_reverse(tv.variant->id, rkey, tv.ciphertext, out) == SIMONSPECK_OK &&
+              memcmp(out, tv.plaintext, tv.block_bytes) == 0, "%s: decrypt_reverse", tv.variant->name);
+        checks++;
+    }
+
+    // Random keys against a context, the reverse key computed in place
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        const simonspeck_variant *v = &simonspeck_variants[id];
+        size_t block = v->block_size / 8u;
+        for (int i = 0; i < KEYS; i++)
+        {
+            uint8_t key[32], pt[16], ct[16], out[16];
+            test_fill(key, sizeof(key), &seed);
+            test_fill(pt, block, &seed);
+            simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+            simonspeck_encrypt(ctx, pt, ct);
+            simonspeck_free(ctx);
+
+            CHECK(simonspeck_reverse_key((simonspeck_variant_id)id, key, key) == SIMONSPECK_OK &&
+                  simonspeck_decrypt_reverse((simonspeck_variant_id)id, key, ct, out) == SIMONSPECK_OK &&
+                  memcmp(out, pt, block) == 0, "%s: decrypt_reverse key %d", v->name, i);
+            CHECK(simonspeck_decrypt_reverse((simonspeck_variant_id)id, key, ct, ct) == SIMONSPECK_OK &&
+                  memcmp(ct, pt, block) == 0, "%s: decrypt_reverse key %d in place", v->name, i);
+            checks += 2;
+        }
+    }
+
+    uint8_t key[32] = {0};
+    CHECK(simonspeck_reverse_key(SIMONSPECK_VARIANT_COUNT, key, key) == SIMONSPECK_EINVAL &&
+          simonspeck_decrypt_reverse(SIMONSPECK_VARIANT_COUNT, key, NULL, NULL) == SIMONSPECK_EINVAL,
+          "reverse unknown id");
+    checks++;
+    return test_summary("reverse", checks);
+}
@@ -0,0 +1,49 @@
+/**
+* simon_hpp.cpp - The header-only C++ Simon engine checked against the C library
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+
+#include "engine.hpp"
+#include "simon.hpp"
+
+int main()
+{
+    using namespace simonspeck;
+    std::uint32_t seed = 0xbb67ae85;
+    unsigned checks = 0;
+
+    checks += check_engine<Simon64_32>(SIMON_64_32, &seed);
+    checks += check_engine<Simon72_48>(SIMON_72_48, &seed);
+    checks += check_engine<Simon96_48>(SIMON_96_48, &seed);
+    checks += check_engine<Simon96_64>(SIMON_96_64, &seed);
+    checks += check_engine<Simon128_64>(SIMON_128_64, &seed);
+    checks += check_engine<Simon96_96>(SIMON_96_96, &seed);
+    checks += check_engine<Simon144_96>(SIMON_144_96, &seed);
+    checks += check_engine<Simon128_128>(SIMON_128_128, &seed);
+    checks += check_engine<Simon192_128>(SIMON_192_128, &seed);
+    checks += check_engine<Simon256_128>(SIMON_256_128, &seed);
+    return test_summary("simon_hpp", checks);
+}
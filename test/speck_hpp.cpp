@@ -0,0 +1,49 @@
+/**
+* speck_hpp.cpp - The header-only C++ Speck engine checked against the C library
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+
+#include "engine.hpp"
+#include "speck.hpp"
+
+int main()
+{
+    using namespace simonspeck;
+    std::uint32_t seed = 0x6a09e667;
+    unsigned checks = 0;
+
+    checks += check_engine<Speck64_32>(SPECK_64_32, &seed);
+    checks += check_engine<Speck72_48>(SPECK_72_48, &seed);
+    checks += check_engine<Speck96_48>(SPECK_96_48, &seed);
+    checks += check_engine<Speck96_64>(SPECK_96_64, &seed);
+    checks += check_engine<Speck128_64>(SPECK_128_64, &seed);
+    checks += check_engine<Speck96_96>(SPECK_96_96, &seed);
+    checks += check_engine<Speck144_96>(SPECK_144_96, &seed);
+    checks += check_engine<Speck128_128>(SPECK_128_128, &seed);
+    checks += check_engine<Speck192_128>(SPECK_192_128, &seed);
+    checks += check_engine<Speck256_128>(SPECK_256_128, &seed);
+    return test_summary("speck_hpp", checks);
+}
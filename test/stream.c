@@ -0,0 +1,190 @@
+/**
+* stream.c - Streaming contexts fed in uneven chunks against the one-shot modes
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+// Message shapes for the streams: one-shot GCM is the reference
+static const struct {
+    const char *name;
+    size_t len, aad_len, iv_len, tag_len;
+} gcm_streams[] = {
+    {"speck128_128", 0, 0, 12, 16}, {"speck128_128", 37, 13, 12, 16}, {"speck128_128", 64, 20, 8, 12},
+    {"simon128_128", 0, 0, 12, 16}, {"simon128_128", 37, 13, 12, 16}, {"simon128_128", 64, 20, 8, 12},
+};
+
+static const size_t lengths[] = {0, 1, 7, 15, 16, 17, 31, 100, 1030, 2100, 5000};
+
+static uint8_t in[8192], out[8192], want[8192], tmp[8192];
+static unsigned checks;
+
+static simonspeck_variant_id variant_id(const char *name)
+{
+    return simonspeck_find_variant(name)->id;
+}
+
+// The one-shot modes have their own tests and are the reference here
+static void test_ctr(simonspeck_ctx *ctx, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u;
+    uint8_t iv[16];
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        size_t len = lengths[i];
+        test_fill(iv, block, seed);
+        memset(iv + block - 4, 0, 4);
+        simonspeck_ctr(ctx, iv, 4, in, want, len);
+
+        // Chunked through the stream, in place
+        simonspeck_ctr_stream *s = simonspeck_ctr_stream_new(ctx);
+        simonspeck_ctr_stream_init(s, iv, 4);
+        memcpy(tmp, in, len);
+        for (size_t done = 0, n = 1; done < len; done += n, n = n * 3 % 67)
+        {
+            n = n < len - done ? n : len - done;
+            simonspeck_ctr_stream_update(s, tmp + done, tmp + done, n);
+        }
+        CHECK(memcmp(tmp, want, len) == 0, "%s: ctr stream %zu bytes", v->name, len);
+        simonspeck_ctr_stream_free(s);
+        checks++;
+    }
+}
+
+// The stream refuses to run past the last counter value of every width
+static void test_ctr_wrap(simonspeck_ctx *ctx, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u;
+    uint8_t iv[16];
+
+    for (unsigned width = 1; width <= block; width++)
+    {
+        test_fill(iv, block, seed);
+        memset(iv + block - width, 0xff, width);
+        simonspeck_ctr_stream *s = simonspeck_ctr_stream_new(ctx);
+        simonspeck_ctr_stream_init(s, iv, width);
+        CHECK(simonspeck_ctr_stream_update(s, in, out, block) == SIMONSPECK_OK, "%s: ctr stream width %u",
+              v->name, width);
+        CHECK(simonspeck_ctr_stream_update(s, in, out, 1) == SIMONSPECK_ERANGE, "%s: ctr stream width %u wrap",
+              v->name, width);
+        simonspeck_ctr_stream_free(s);
+        checks += 2;
+    }
+}
+
+static void test_cbc(simonspeck_ctx *ctx, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u;
+    uint8_t iv[16];
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        size_t len = lengths[i] / block * block, out_len;
+        test_fill(iv, block, seed);
+
+        simonspeck_cbc_encrypt(ctx, iv, in, want, len);
+
+        simonspeck_cbc_stream *s = simonspeck_cbc_stream_new(ctx);
+        simonspeck_cbc_stream_init(s, iv, 1);
+        size_t total = 0;
+        for (size_t done = 0, n = 5; done < len; done += n, n = n * 7 % 71)
+        {
+            n = n < len - done ? n : len - done;
+            simonspeck_cbc_stream_update(s, want + done, n, tmp + total, &out_len);
+            total += out_len;
+        }
+        CHECK(total == len && memcmp(tmp, in, len) == 0 && simonspeck_cbc_stream_final(s) == SIMONSPECK_OK,
+              "%s: cbc stream %zu bytes", v->name, len);
+        simonspeck_cbc_stream_update(s, in, 1, tmp, &out_len);
+        CHECK(simonspeck_cbc_stream_final(s) == SIMONSPECK_EINVAL, "%s: cbc stream partial", v->name);
+        simonspeck_cbc_stream_free(s);
+        checks += 2;
+    }
+}
+
+static void test_gcm_stream(void)
+{
+    uint8_t key[32], iv[16], aad[32], tag[16];
+    test_pattern(key, sizeof(key), 0, 1);
+    test_pattern(iv, sizeof(iv), 0xa0, 1);
+    test_pattern(aad, sizeof(aad), 0xc0, 3);
+    test_pattern(in, 64, 3, 7);
+
+    for (size_t i = 0; i < sizeof(gcm_streams) / sizeof(gcm_streams[0]); i++)
+    {
+        const char *name = gcm_streams[i].name;
+        size_t len = gcm_streams[i].len, aad_len = gcm_streams[i].aad_len;
+        size_t iv_len = gcm_streams[i].iv_len, tag_len = gcm_streams[i].tag_len;
+        simonspeck_gcm *gcm = simonspeck_gcm_new(variant_id(name), key);
+        simonspeck_gcm_seal(gcm, iv, iv_len, aad, aad_len, in, out, len, tag, tag_len);
+
+        // The stream, sealing then opening in uneven chunks
+        uint8_t tag2[16];
+        simonspeck_gcm_stream *s = simonspeck_gcm_stream_new(gcm);
+        simonspeck_gcm_stream_init(s, iv, iv_len, 0);
+        simonspeck_gcm_stream_aad(s, aad, aad_len / 2);
+        simonspeck_gcm_stream_aad(s, aad + aad_len / 2, aad_len - aad_len / 2);
+        simonspeck_gcm_stream_update(s, in, tmp, len / 3);
+        simonspeck_gcm_stream_update(s, in + len / 3, tmp + len / 3, len - len / 3);
+        simonspeck_gcm_stream_final(s, tag2, tag_len);
+        CHECK(memcmp(tmp, out, len) == 0 && memcmp(tag2, tag, tag_len) == 0, "%s: gcm stream seal %zu", name, i);
+        simonspeck_gcm_stream_init(s, iv, iv_len, 1);
+        simonspeck_gcm_stream_aad(s, aad, aad_len);
+        simonspeck_gcm_stream_update(s, out, tmp, len);
+        CHECK(simonspeck_gcm_stream_verify(s, tag, tag_len) == SIMONSPECK_OK && memcmp(tmp, in, len) == 0,
+              "%s: gcm stream open %zu", name, i);
+        simonspeck_gcm_stream_free(s);
+
+        checks += 2;
+        simonspeck_gcm_free(gcm);
+    }
+}
+
+int main(void)
+{
+    uint32_t seed = 0x2545f491;
+
+    test_fill(in, sizeof(in), &seed);
+    for (int id = 0; id < SIMONSPECK_VARIANT_COUNT; id++)
+    {
+        uint8_t key[32];
+        test_fill(key, sizeof(key), &seed);
+        simonspeck_ctx *ctx = simonspeck_new((simonspeck_variant_id)id, key);
+        test_ctr(ctx, &seed);
+        test_ctr_wrap(ctx, &seed);
+        test_cbc(ctx, &seed);
+        simonspeck_free(ctx);
+    }
+    test_gcm_stream();
+    return test_summary("stream", checks);
+}
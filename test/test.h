@@ -0,0 +1,131 @@
+/**
+* test.h - Helpers shared by the test programs
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_TEST_H
+#define SIMONSPECK_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simonspeck.h"
+
+// Every test program is a main() that prints a line per failure and a
+// summary, and returns non-zero if anything failed
+static int failures;
+
+#define CHECK(cond, ...) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            failures++; \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+        } \
+    } while (0)
+
+static inline int test_summary(const char *name, unsigned checks)
+{
+    printf("%s: %u checks, %d failed\n", name, checks, failures);
+    return failures != 0;
+}
+
+// Deterministic bytes, xorshift32
+static inline void test_fill(uint8_t *p, size_t n, uint32_t *seed)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        *seed ^= *seed << 13;
+        *seed ^= *seed >> 17;
+        *seed ^= *seed << 5;
+        p[i] = (uint8_t)*seed;
+    }
+}
+
+// The byte patterns behind the fixed mode vectors, p[i] = start + i * step
+static inline void test_pattern(uint8_t *p, size_t n, unsigned start, unsigned step)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        p[i] = (uint8_t)(start + i * step);
+    }
+}
+
+static inline size_t test_unhex(const char *s, uint8_t *out)
+{
+    size_t n = 0;
+    for (; s[0] != '\0' && s[1] != '\0'; s += 2)
+    {
+        unsigned b;
+        sscanf(s, "%2x", &b);
+        out[n++] = (uint8_t)b;
+    }
+    return n;
+}
+
+static inline int test_equal_hex(const uint8_t *p, size_t n, const char *hex)
+{
+    uint8_t want[8192];
+    return test_unhex(hex, want) == n && memcmp(p, want, n) == 0;
+}
+
+// encrypt_blocks and decrypt_blocks over n random blocks at in + offset,
+// out of place and in place, against simonspeck_encrypt one at a time
+static inline unsigned test_blocks(simonspeck_ctx *ctx, size_t n, size_t offset, uint32_t *seed)
+{
+    const simonspeck_variant *v = simonspeck_ctx_variant(ctx);
+    size_t block = v->block_size / 8u, len = n * block;
+    uint8_t *pt = (uint8_t *)malloc(len + 1), *ct = (uint8_t *)malloc(len + 1);
+    uint8_t *want = (uint8_t *)malloc(len + 1);
+    unsigned checks = 0;
+
+    test_fill(pt + offset, len, seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        simonspeck_encrypt(ctx, pt + offset + i * block, want + i * block);
+    }
+
+    simonspeck_encrypt_blocks(ctx, pt + offset, ct + offset, n);
+    CHECK(memcmp(ct + offset, want, len) == 0, "%s %s: encrypt %zu blocks at +%zu",
+          v->name, simonspeck_ctx_tier(ctx), n, offset);
+    simonspeck_decrypt_blocks(ctx, ct + offset, ct + offset, n);
+    CHECK(memcmp(ct + offset, pt + offset, len) == 0, "%s %s: decrypt %zu blocks in place at +%zu",
+          v->name, simonspeck_ctx_tier(ctx), n, offset);
+    simonspeck_encrypt_blocks(ctx, ct + offset, ct + offset, n);
+    CHECK(memcmp(ct + offset, want, len) == 0, "%s %s: encrypt %zu blocks in place at +%zu",
+          v->name, simonspeck_ctx_tier(ctx), n, offset);
+    checks += 3;
+
+    free(pt);
+    free(ct);
+    free(want);
+    return checks;
+}
+
+#endif
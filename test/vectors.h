@@ -0,0 +1,120 @@
+/**
+* vectors.h - Test vectors from the Simon and Speck paper
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef SIMONSPECK_TEST_VECTORS_H
+#define SIMONSPECK_TEST_VECTORS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "simonspeck.h"
+
+// Test vectors of "The Simon and Speck Families of Lightweight Block
+// Ciphers", appendix B, in the paper's notation: words most significant
+// first. The library's bytes are the words in reverse, little endian.
+static const struct {
+    const char *name;
+    const char *key, *plaintext, *ciphertext;
+} test_paper[] = {
+    {"simon64_32", "1918 1110 0908 0100", "6565 6877", "c69b e9bb"},
+    {"simon72_48", "121110 0a0908 020100", "612067 6e696c", "dae5ac 292cac"},
+    {"simon96_48", "1a1918 121110 0a0908 020100", "726963 20646e", "6e06a5 acf156"},
+    {"simon96_64", "13121110 0b0a0908 03020100", "6f722067 6e696c63", "5ca2e27f 111a8fc8"},
+    {"simon128_64", "1b1a1918 13121110 0b0a0908 03020100", "656b696c 20646e75", "44c8fc20 b9dfa07a"},
+    {"simon96_96", "0d0c0b0a0908 050403020100", "2072616c6c69 702065687420", "602807a462b4 69063d8ff082"},
+    {"simon144_96", "151413121110 0d0c0b0a0908 050403020100", "746168742074 73756420666f",
+     "ecad1c6c451e 3f59c5db1ae9"},
+    {"simon128_128", "0f0e0d0c0b0a0908 0706050403020100", "6373656420737265 6c6c657661727420",
+     "49681b1e1e54fe3f 65aa832af84e0bbc"},
+    {"simon192_128", "1716151413121110 0f0e0d0c0b0a0908 0706050403020100",
+     "206572656874206e 6568772065626972", "c4ac61effcdc0d4f 6c9c8d6e2597b85b"},
+    {"simon256_128", "1f1e1d1c1b1a1918 1716151413121110 0f0e0d0c0b0a0908 0706050403020100",
+     "74206e69206d6f6f 6d69732061207369", "8d2b5579afc8a3a0 3bf72a87efe7b868"},
+    {"speck64_32", "1918 1110 0908 0100", "6574 694c", "a868 42f2"},
+    {"speck72_48", "121110 0a0908 020100", "20796c 6c6172", "c049a5 385adc"},
+    {"speck96_48", "1a1918 121110 0a0908 020100", "6d2073 696874", "735e10 b6445d"},
+    {"speck96_64", "13121110 0b0a0908 03020100", "74614620 736e6165", "9f7952ec 4175946c"},
+    {"speck128_64", "1b1a1918 13121110 0b0a0908 03020100", "3b726574 7475432d", "8c6fa548 454e028b"},
+    {"speck96_96", "0d0c0b0a0908 050403020100", "65776f68202c 656761737520", "9e4d09ab7178 62bdde8f79aa"},
+    {"speck144_96", "151413121110 0d0c0b0a0908 050403020100", "656d6974206e 69202c726576",
+     "2bf31072228a 7ae440252ee6"},
+    {"speck128_128", "0f0e0d0c0b0a0908 0706050403020100", "6c61766975716520 7469206564616d20",
+     "a65d985179783265 7860fedf5c570d18"},
+    {"speck192_128", "1716151413121110 0f0e0d0c0b0a0908 0706050403020100",
+     "7261482066656968 43206f7420746e65", "1be4cf3a13135566 f9bc185de03c1886"},
+    {"speck256_128", "1f1e1d1c1b1a1918 1716151413121110 0f0e0d0c0b0a0908 0706050403020100",
+     "65736f6874206e49 202e72656e6f6f70", "4109010405c0f53e 4eeeb48d9c188f43"},
+};
+
+#define TEST_PAPER_COUNT (sizeof(test_paper) / sizeof(test_paper[0]))
+
+// One vector in library bytes
+struct test_vector {
+    const simonspeck_variant *variant;
+    uint8_t key[32], plaintext[16], ciphertext[16];
+    size_t key_bytes, block_bytes;
+};
+
+// Paper words to library bytes
+static inline size_t test_paper_bytes(const char *words, uint8_t *out)
+{
+    uint8_t big[64];
+    size_t n = 0;
+
+    for (const char *p = words; *p != '\0'; p++)
+    {
+        if (*p == ' ')
+        {
+            continue;
+        }
+        unsigned b;
+        sscanf(p, "%2x", &b);
+        big[n++] = (uint8_t)b;
+        p++;
+    }
+
+    // Reverse the whole string: word order and the bytes in each word
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = big[n - 1 - i];
+    }
+    return n;
+}
+
+// Vector i, variant NULL if the registry does not know its name
+static inline struct test_vector test_paper_vector(size_t i)
+{
+    struct test_vector v;
+    memset(&v, 0, sizeof(v));
+    v.variant = simonspeck_find_variant(test_paper[i].name);
+    v.key_bytes = test_paper_bytes(test_paper[i].key, v.key);
+    v.block_bytes = test_paper_bytes(test_paper[i].plaintext, v.plaintext);
+    test_paper_bytes(test_paper[i].ciphertext, v.ciphertext);
+    return v;
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+* xts.c - XTS mode against fixed vectors
+*
+* Author: Cas van der Weegen <cas@vdweegen.com>
+*
+* Copyright (c) 2017 Cas van der Weegen
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+// Vectors come from an independent Python model of XTS over the paper's
+// cipher definitions. Key[i] = i, tweak key[i] = 0x80 + i, plaintext[i] =
+// 3 + 7i, sector 0x0123456789abcdef, 64 bytes.
+static const struct {
+    const char *name, *ciphertext;
+} xts_vectors[] = {
+    {"speck128_128",
+     "4ba4ad525f5c95d59023637d841917a2f4c4aa77fd82f381e6014c536e15e7f2"
+     "58db9643aff388622313f464c25a9969577e5aa741eb0f8f4dcf465acada8688"},
+    {"simon128_128",
+     "59e660599032e3f80d3f3e5b4a191a58e4d8f0edd86bd73e20c689478265a60c"
+     "75b3968bcb4fa691431befdcc04bd76945f779c17411ad5f47e478481da1e229"},
+};
+
+static uint8_t in[8192], out[8192], want[8192];
+static unsigned checks;
+
+static void test_xts(void)
+{
+    uint8_t key[32], tweak_key[32];
+    test_pattern(key, sizeof(key), 0, 1);
+    test_pattern(tweak_key, sizeof(tweak_key), 0x80, 1);
+    test_pattern(in, 64, 3, 7);
+
+    for (size_t i = 0; i < sizeof(xts_vectors) / sizeof(xts_vectors[0]); i++)
+    {
+        simonspeck_variant_id id = simonspeck_find_variant(xts_vectors[i].name)->id;
+        simonspeck_ctx *data = simonspeck_new(id, key), *tweak = simonspeck_new(id, tweak_key);
+
+        CHECK(simonspeck_xts_encrypt(data, tweak, 0x0123456789abcdefu, in, out, 64) == SIMONSPECK_OK &&
+              test_equal_hex(out, 64, xts_vectors[i].ciphertext), "%s: xts vector", xts_vectors[i].name);
+        CHECK(simonspeck_xts_decrypt(data, tweak, 0x0123456789abcdefu, out, out, 64) == SIMONSPECK_OK &&
+              memcmp(out, in, 64) == 0, "%s: xts decrypt", xts_vectors[i].name);
+
+        // Many sectors at once match one sector at a time
+        uint64_t sectors[5] = {7, 0, 1u << 31, 5, UINT64_MAX};
+        test_pattern(in, 5 * 512, 1, 13);
+        for (size_t s = 0; s < 5; s++)
+        {
+            simonspeck_xts_encrypt(data, tweak, sectors[s], in + s * 512, want + s * 512, 512);
+        }
+        CHECK(simonspeck_xts_encrypt_sectors(data, tweak, sectors, 5, 512, in, out) == SIMONSPECK_OK &&
+              memcmp(out, want, 5 * 512) == 0, "%s: xts sectors", xts_vectors[i].name);
+        CHECK(simonspeck_xts_decrypt_sectors(data, tweak, sectors, 5, 512, out, out) == SIMONSPECK_OK &&
+              memcmp(out, in, 5 * 512) == 0, "%s: xts decrypt sectors", xts_vectors[i].name);
+        CHECK(simonspeck_xts_encrypt(data, tweak, 0, in, out, 24) == SIMONSPECK_EINVAL,
+              "%s: xts partial block", xts_vectors[i].name);
+        checks += 5;
+
+        simonspeck_free(data);
+        simonspeck_free(tweak);
+        test_pattern(in, 64, 3, 7);
+    }
+
+    simonspeck_ctx *small = simonspeck_new(SPECK_96_64, key);
+    CHECK(simonspeck_xts_encrypt(small, small, 0, in, out, 32) == SIMONSPECK_EINVAL, "xts 64-bit blocks");
+    simonspeck_free(small);
+    checks++;
+}
+
+int main(void)
+{
+    test_xts();
+    return test_summary("xts", checks);
+}